@@ -0,0 +1,480 @@
+#include <iostream>
+#include <string>
+#include <functional>
+#include <sstream>
+#include <chrono>
+#include <cmath>
+#include <algorithm>
+#include <numeric>
+#include <type_traits>
+#include <stdexcept>
+#include <vector>
+#include <array>
+#include <optional>
+#include <cstdint>
+#include <iomanip>
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#include "graph/graph.hpp"
+#include "graph/satgraph.hpp"
+#include "graph/fixedgraph.hpp"
+#include "graph/counters.hpp"
+#include "sat/cdcl.hpp"
+#include "parser.hpp"
+
+
+
+
+/* HARDWARE COUNTERS */
+
+/**
+ * @brief cycles, instructions, cache misses & branch misses of the calling thread (user space only), read through
+ * perf_event_open. Counters the kernel doesn't allow (or that don't exist, as in many VMs) are missing
+*/
+class PerfCounters {
+    public:
+        static constexpr std::size_t n_events = 4;
+        static constexpr std::array<const char *, n_events> names {"cycles", "instructions", "cache_misses", "branch_misses"};
+
+        PerfCounters();
+        ~PerfCounters();
+
+        PerfCounters(const PerfCounters &) = delete;
+        PerfCounters & operator = (const PerfCounters &) = delete;
+
+        /**
+        * @brief starts (or resumes) counting
+        */
+        void start();
+
+        /**
+        * @brief pauses counting. The counts add up over every start/stop
+        */
+        void stop();
+
+        /**
+        * @brief count of event i, scaled up if the kernel multiplexed it (nothing if it isn't available)
+        */
+        std::optional<double> read(std::size_t i) const;
+
+
+    private:
+        std::array<int, n_events> fds;  // -1 = not available
+};
+
+
+#if defined(__linux__)
+
+PerfCounters::PerfCounters() : fds {} {
+    constexpr std::array<std::uint64_t, n_events> configs {
+        PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS, PERF_COUNT_HW_CACHE_MISSES, PERF_COUNT_HW_BRANCH_MISSES
+    };
+
+    for (std::size_t i = 0; i < n_events; ++i) {
+        perf_event_attr attr {};
+        attr.size = sizeof(attr);
+        attr.type = PERF_TYPE_HARDWARE;
+        attr.config = configs[i];
+        attr.disabled = 1;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+        fds[i] = static_cast<int>(::syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));  // this thread, any CPU
+    }
+}
+
+
+PerfCounters::~PerfCounters() {
+    for (auto & fd : fds) if (fd >= 0) ::close(fd);
+}
+
+
+void PerfCounters::start() {
+    for (auto & fd : fds) if (fd >= 0) ::ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+}
+
+
+void PerfCounters::stop() {
+    for (auto & fd : fds) if (fd >= 0) ::ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+}
+
+
+std::optional<double> PerfCounters::read(std::size_t i) const {
+    if (fds[i] < 0) return std::nullopt;
+
+    std::uint64_t values[3] {};  // value, time enabled, time running
+    if (::read(fds[i], values, sizeof(values)) != sizeof(values) || values[2] == 0) return std::nullopt;
+
+    return static_cast<double>(values[0]) * values[1] / values[2];
+}
+
+#else
+
+PerfCounters::PerfCounters() : fds {} { fds.fill(-1); }
+PerfCounters::~PerfCounters() = default;
+void PerfCounters::start() { }
+void PerfCounters::stop() { }
+std::optional<double> PerfCounters::read(std::size_t) const { return std::nullopt; }
+
+#endif
+
+
+
+
+/* STATISTICS */
+
+/**
+ * @brief summary of the time per call of a benchmark, in nanoseconds
+*/
+struct Summary {
+    std::size_t samples = 0;
+    std::size_t batch = 0;  // calls per sample
+    double min = 0, p5 = 0, p25 = 0, median = 0, p75 = 0, p95 = 0, max = 0;
+    double mean = 0, stddev = 0;  // without the outliers
+    std::size_t outliers = 0;  // samples outside the Tukey fences (1.5 IQR past the quartiles)
+    std::array<std::optional<double>, PerfCounters::n_events> counters {};  // per call
+};
+
+
+/**
+ * @brief percentile q (0..1) of sorted values, interpolating between the closest two
+*/
+static double percentile(const std::vector<double> & sorted, double q) {
+    const double x = q * (sorted.size() - 1);
+    const std::size_t i = static_cast<std::size_t>(x);
+    if (i + 1 >= sorted.size()) return sorted.back();
+    return sorted[i] + (x - i) * (sorted[i + 1] - sorted[i]);
+}
+
+
+static Summary summarize(std::vector<double> samples) {
+    Summary s {};
+    std::sort(samples.begin(), samples.end());
+
+    s.samples = samples.size();
+    s.min = samples.front();
+    s.p5 = percentile(samples, 0.05);
+    s.p25 = percentile(samples, 0.25);
+    s.median = percentile(samples, 0.5);
+    s.p75 = percentile(samples, 0.75);
+    s.p95 = percentile(samples, 0.95);
+    s.max = samples.back();
+
+    // interruptions (scheduling, page faults...) only make samples slower: they're dropped from the mean
+    const double iqr = s.p75 - s.p25;
+    std::vector<double> kept {};
+    for (auto & x : samples) {
+        if (x < s.p25 - 1.5 * iqr || x > s.p75 + 1.5 * iqr) ++s.outliers;
+        else kept.push_back(x);
+    }
+
+    s.mean = std::accumulate(kept.begin(), kept.end(), 0.0) / kept.size();
+    double squares = 0;
+    for (auto & x : kept) squares += (x - s.mean) * (x - s.mean);
+    s.stddev = kept.size() > 1 ? std::sqrt(squares / (kept.size() - 1)) : 0;
+
+    return s;
+}
+
+
+
+
+/* MEASUREMENT */
+
+struct Options {
+    double warmup;  // seconds
+    double min_time;  // seconds
+    double max_time;  // seconds
+    std::size_t min_samples;
+    std::size_t max_samples;
+    double precision;  // target relative standard error of the median
+};
+
+using clock_type = std::chrono::steady_clock;
+
+constexpr double min_sample_time = 50e-6;  // seconds: well above the clock resolution and overhead
+
+static volatile bool sink = false;  // results of the calls are stored, so they can't be optimized away
+
+static double seconds(clock_type::duration d) { return std::chrono::duration<double>(d).count(); }
+
+
+/**
+ * @brief times `run` on copies of `input` (so results cached by a graph aren't reused by the next call)
+ *
+ * After warming up, calls are timed in batches long enough for the clock to be precise. Samples are taken
+ * until the median is known within `precision` (and at least `min_samples` and `min_time`), or `max_time`
+ * or `max_samples` is reached. Hardware counters are only enabled around the timed calls.
+*/
+template <typename Input>
+Summary measure(const Input & input, std::function<bool(const Input &)> run, const Options & options) {
+    std::vector<Input> copies {};
+    auto prepare = [&](std::size_t batch) { copies.assign(batch, input); };  // not timed
+
+    // warm-up (caches, branch predictors, frequency scaling), also estimating the time of a call
+    std::size_t calls = 0;
+    clock_type::duration busy {};
+    const auto warmup_start = clock_type::now();
+    do {
+        prepare(1);
+        const auto tic = clock_type::now();
+        sink = run(copies[0]);
+        busy += clock_type::now() - tic;
+        ++calls;
+    } while (seconds(clock_type::now() - warmup_start) < options.warmup);
+
+    const double call_time = seconds(busy) / calls;
+    const std::size_t batch = std::max<std::size_t>(1, std::ceil(min_sample_time / std::max(call_time, 1e-9)));
+
+    PerfCounters counters {};
+    std::vector<double> samples {};
+    std::vector<double> scratch {};
+    std::size_t next_check = options.min_samples;
+
+    const auto start = clock_type::now();
+    while (samples.size() < options.max_samples) {
+        prepare(batch);
+
+        counters.start();
+        const auto tic = clock_type::now();
+        for (auto & copy : copies) sink = run(copy);
+        const auto toc = clock_type::now();
+        counters.stop();
+
+        samples.push_back(std::chrono::duration<double, std::nano>(toc - tic).count() / batch);
+
+        const double elapsed = seconds(clock_type::now() - start);
+        if (elapsed >= options.max_time) break;
+        if (samples.size() < next_check || elapsed < options.min_time) continue;
+        next_check = samples.size() + samples.size() / 4;  // checks are O(samples): geometrically spaced
+
+        // standard error of the median, estimated from the MAD so a few interrupted samples don't keep it high
+        scratch = samples;
+        auto middle = scratch.begin() + scratch.size() / 2;
+        std::nth_element(scratch.begin(), middle, scratch.end());
+        const double median = *middle;
+        for (auto & x : scratch) x = std::abs(x - median);
+        std::nth_element(scratch.begin(), middle, scratch.end());
+        const double sigma = 1.4826 * *middle;
+
+        if (1.2533 * sigma / std::sqrt(samples.size()) <= options.precision * median) break;
+    }
+
+    Summary summary = summarize(samples);
+    summary.batch = batch;
+    for (std::size_t i = 0; i < PerfCounters::n_events; ++i) {
+        if (auto count = counters.read(i)) summary.counters[i] = *count / (samples.size() * batch);
+    }
+
+    return summary;
+}
+
+
+static void print_summary(const Summary & s) {
+    std::cout << "\"samples\":" << s.samples << ",";
+    std::cout << "\"batch\":" << s.batch << ",";
+    std::cout << "\"median\":" << s.median << ",";
+    std::cout << "\"p5\":" << s.p5 << ",";
+    std::cout << "\"p25\":" << s.p25 << ",";
+    std::cout << "\"p75\":" << s.p75 << ",";
+    std::cout << "\"p95\":" << s.p95 << ",";
+    std::cout << "\"min\":" << s.min << ",";
+    std::cout << "\"max\":" << s.max << ",";
+    std::cout << "\"mean\":" << s.mean << ",";
+    std::cout << "\"stddev\":" << s.stddev << ",";
+    std::cout << "\"outliers\":" << s.outliers;
+
+    for (std::size_t i = 0; i < PerfCounters::n_events; ++i) {
+        std::cout << ",\"" << PerfCounters::names[i] << "\":";
+        if (s.counters[i]) std::cout << *s.counters[i];
+        else std::cout << "null";
+    }
+}
+
+
+
+
+/* ALGORITHMS */
+
+/**
+ * @brief PATH or CLIQUE algorithm on graphs of type G, with the same arguments as p2 (u = 0, v = n - 1, k = n / 2),
+ * or PATH(u, v) for every pair u < v with PATH-ALL (batched) & PATH-ALL-BFS (a query at a time)
+ * @return nothing if it's unknown (or not available for G)
+*/
+template <typename G>
+std::function<bool(const G &)> graph_algorithm(const std::string & name, int n, unsigned threads) {
+    constexpr bool dense = std::is_base_of_v<Graph, G>;
+    const int v = n - 1;
+    const int k = n / 2;
+
+    if (name == "PATH-DFS") return [v](const G & g) { return g.path_dfs(0, v); };
+    if (name == "PATH-BFS") return [v](const G & g) { return g.path_bfs(0, v); };
+    if (name == "PATH-FW") return [v, threads](const G & g) { return g.path_fw(0, v, threads); };
+    if (name == "PATH-TC") return [v, threads](const G & g) { return g.path_tc(0, v, threads); };
+    if (name == "PATH-UF") return [v](const G & g) { return g.path_uf(0, v); };
+    if constexpr (dense) {
+        if (name == "PATH-FIXED" && n <= 256) return [v](const G & g) {
+            bool result = false;
+            with_fixed_graph(g.adjacency(), [&](const auto & fixed) { result = fixed.path(0, v); });
+            return result;
+        };
+    }
+    if (name.starts_with("PATH-ALL")) {
+        // PATH(u, v) for every pair u < v (true if they're all connected)
+        std::vector<std::pair<int, int>> pairs {};
+        for (int a = 0; a < n; ++a) {
+            for (int b = a + 1; b < n; ++b) pairs.emplace_back(a, b);
+        }
+
+        if (name == "PATH-ALL") return [pairs](const G & g) { return std::ranges::count(g.path_many(pairs), true) == std::ssize(pairs); };
+        if (name == "PATH-ALL-BFS") return [pairs](const G & g) { return std::ranges::count_if(pairs, [&](auto & q) { return g.path_bfs(q.first, q.second); }) == std::ssize(pairs); };
+    }
+    if (name == "CLIQUE") {
+        if constexpr (dense) {
+            if (threads != 1) return [k, threads](const G & g) { return g.k_clique_parallel(k, threads); };
+        }
+        return [k](const G & g) { return g.k_clique(k); };
+    }
+    if constexpr (dense) {
+        if (name == "CLIQUE-BT") return [k](const G & g) { return g.k_clique_bt(k); };
+        if (name == "CLIQUE-BBMC") return [k](const G & g) { return g.k_clique_bbmc(k); };
+        if (name == "CLIQUE-FIXED" && n <= 256) return [k](const G & g) {
+            bool result = false;
+            with_fixed_graph(g.adjacency(), [&](const auto & fixed) { result = fixed.k_clique(k); });
+            return result;
+        };
+    }
+
+    return nullptr;
+}
+
+
+/**
+ * @brief SAT algorithm on a formula (building the solver or the graph is part of the call)
+*/
+static std::function<bool(const CNF &)> sat_algorithm(const std::string & name) {
+    if (name == "SAT-CLIQUE") return [](const CNF & cnf) { return SatGraph {cnf}.satisfiable(); };
+    if (name == "SAT-CDCL") return [](const CNF & cnf) { return CDCLSolver {cnf}.solve(); };
+    return nullptr;
+}
+
+
+
+
+/* CLI */
+
+DEFINE_int(n, 100, "size of the graph");
+DEFINE_float(p, 0.5, "probability of an edge between two nodes");
+DEFINE_string(algorithm, "PATH-BFS,PATH-DFS", "comma-separated algorithms to compare, on the same input (PATH-DFS, PATH-BFS, PATH-FW, PATH-TC, PATH-UF, PATH-ALL, PATH-ALL-BFS, PATH-FIXED, CLIQUE, CLIQUE-BT, CLIQUE-BBMC, CLIQUE-FIXED, SAT-CLIQUE, SAT-CDCL)");
+DEFINE_bool(csr, false, "generate a sparse graph in CSR format instead of an adjacency matrix (PATH & CLIQUE)");
+DEFINE_int(threads, 1, "number of threads for PATH-FW, PATH-TC, CLIQUE and to generate the graph (0 = one per core)");
+DEFINE_int(seed, 1, "seed of the random graph");
+DEFINE_string(input, "", "file with the SAT problem (DIMACS CNF or the SAT-PROBLEM syntax), for SAT algorithms");
+DEFINE_float(warmup, 0.1, "seconds of warm-up before timing");
+DEFINE_float(min_time, 0.5, "minimum seconds of timing");
+DEFINE_float(max_time, 10, "maximum seconds of timing");
+DEFINE_int(min_samples, 10, "minimum number of samples");
+DEFINE_int(max_samples, 100000, "maximum number of samples");
+DEFINE_float(precision, 0.01, "stop when the relative standard error of the median is below this (after the minimums)");
+DEFINE_bool(help, false, "show a list of command-line options");
+
+
+
+/**
+ * @brief benchmarks every algorithm of the list on the same input, outputting a JSON line for each
+*/
+template <typename Input, typename Algorithm>
+int run_all(const Input & input, Algorithm algorithm, const Options & options, const std::string & fields) {
+    std::istringstream names {FLAG_algorithm};
+    for (std::string name {}; std::getline(names, name, ',');) {
+        std::transform(name.begin(), name.end(), name.begin(), ::toupper);
+
+        auto run = algorithm(name);
+        if (!run) {
+            std::cerr << "Unknown algorithm '" << name << "'\n";
+            return -1;
+        }
+
+        const Summary summary = measure<Input>(input, run, options);
+
+        std::cout << "{\"algorithm\":\"" << name << "\"," << fields;
+        print_summary(summary);
+        std::cout << "}" << std::endl;
+    }
+
+    return 0;
+}
+
+
+
+int main(int argc, char* argv[]) {
+
+    // parse cli
+    REGISTER_FLAG(argc, argv, n);
+    REGISTER_FLAG(argc, argv, p);
+    REGISTER_FLAG(argc, argv, algorithm);
+    REGISTER_FLAG(argc, argv, csr);
+    REGISTER_FLAG(argc, argv, threads);
+    REGISTER_FLAG(argc, argv, seed);
+    REGISTER_FLAG(argc, argv, input);
+    REGISTER_FLAG(argc, argv, warmup);
+    REGISTER_FLAG(argc, argv, min_time);
+    REGISTER_FLAG(argc, argv, max_time);
+    REGISTER_FLAG(argc, argv, min_samples);
+    REGISTER_FLAG(argc, argv, max_samples);
+    REGISTER_FLAG(argc, argv, precision);
+    REGISTER_FLAG(argc, argv, help);
+
+    if (FLAG_help) {
+        std::cout << "Usage\n  " << argv[0] << " [options]";
+        std::cout << "\n\nOPTIONS";
+        flaghelp();
+        std::cout << "\nOutputs a JSON line per algorithm with the time per call (ns) and the hardware counters per call (null if not available)\n";
+
+        return 0;
+    }
+
+    const Options options {
+        FLAG_warmup, FLAG_min_time, FLAG_max_time,
+        static_cast<std::size_t>(std::max(FLAG_min_samples, 2)), static_cast<std::size_t>(std::max(FLAG_max_samples, 2)),
+        FLAG_precision
+    };
+
+    std::cout << std::fixed << std::setprecision(1);
+
+    /* SAT */
+    if (FLAG_algorithm.starts_with("SAT") || FLAG_algorithm.starts_with("sat")) {
+        try {
+            const CNF cnf = read_cnf(FLAG_input);
+            const std::string fields = "\"input\":\"" + FLAG_input + "\",";
+            return run_all(cnf, sat_algorithm, options, fields);
+        }
+        catch (const std::invalid_argument & e) {
+            std::cerr << "Invalid problem: " << e.what() << "\n";
+            return -1;
+        }
+        catch (const std::runtime_error & e) {
+            std::cerr << e.what() << "\n";
+            return -1;
+        }
+    }
+
+    /* PATH & CLIQUE */
+    std::ostringstream fields {};
+    fields << "\"n\":" << FLAG_n << ",\"p\":" << FLAG_p << ",\"seed\":" << FLAG_seed << ",\"csr\":" << (FLAG_csr ? "true" : "false") << ",";
+
+    if (FLAG_csr) {
+        const CSRGraph graph = RandomUndirectedGraph::sparse(FLAG_n, FLAG_p, static_cast<std::uint64_t>(FLAG_seed), static_cast<unsigned>(FLAG_threads));
+        return run_all(graph, [](const std::string & name) { return graph_algorithm<CSRGraph>(name, FLAG_n, FLAG_threads); }, options, fields.str());
+    }
+
+    const RandomUndirectedGraph graph {FLAG_n, FLAG_p, static_cast<std::uint64_t>(FLAG_seed), static_cast<unsigned>(FLAG_threads)};
+    return run_all(graph, [](const std::string & name) { return graph_algorithm<RandomUndirectedGraph>(name, FLAG_n, FLAG_threads); }, options, fields.str());
+}
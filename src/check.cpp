@@ -0,0 +1,554 @@
+#include <iostream>
+#include <string>
+#include <functional>
+#include <sstream>
+#include <algorithm>
+#include <vector>
+#include <random>
+#include <set>
+#include <mutex>
+#include <stdexcept>
+#include <cstdint>
+#include <cstdlib>
+
+#include "graph/graph.hpp"
+#include "graph/bbmc.hpp"
+#include "graph/satgraph.hpp"
+#include "graph/fixedgraph.hpp"
+#include "graph/random.hpp"
+#include "sat/cdcl.hpp"
+#include "parser.hpp"
+
+
+
+
+/* CHECKS */
+
+/**
+ * @brief results of a check: every comparison made, and the ones that didn't match (the first few are described
+ * on stderr, with the instance to reproduce them)
+*/
+class Check {
+    public:
+        static constexpr std::size_t max_reported = 10;
+
+        explicit Check(std::string name) : name {std::move(name)}, instances {0}, comparisons {0}, mismatches {0} { }
+
+        /**
+        * @brief counts an instance (a graph or formula), described by `what` in the mismatches found on it
+        */
+        void instance(std::string what) {
+            ++instances;
+            current = std::move(what);
+        }
+
+        /**
+        * @brief compares two results of the current instance, `what` naming the solvers and query
+        */
+        template <typename T>
+        void expect(const T & result, const T & expected, const std::string & what) {
+            ++comparisons;
+            if (result == expected) return;
+
+            if (++mismatches <= max_reported) {
+                std::cerr << name << ": " << what << " = " << result << ", expected " << expected << " (" << current << ")\n";
+            }
+        }
+
+        bool passed() const { return mismatches == 0; }
+
+        /* JSON line */
+        friend std::ostream & operator << (std::ostream & out, const Check & c) {
+            out << "{\"check\":\"" << c.name << "\",\"instances\":" << c.instances << ",\"comparisons\":" << c.comparisons;
+            out << ",\"mismatches\":" << c.mismatches << ",\"passed\":" << (c.passed() ? "true" : "false") << "}";
+            return out;
+        }
+
+
+    private:
+        std::string name;
+        std::string current;
+        std::size_t instances;
+        std::size_t comparisons;
+        std::size_t mismatches;
+};
+
+
+/**
+ * @brief random (n, p) of instance i of a check: n in [1, max_n], p in a grid from sparse to almost complete
+*/
+struct Instance {
+    int n;
+    float p;
+    std::uint64_t seed;
+
+    Instance(std::uint64_t check_seed, std::uint64_t i, int max_n) {
+        static constexpr float ps[] = {0.02, 0.05, 0.1, 0.2, 0.3, 0.5, 0.7, 0.9, 1};
+        seed = stream_seed(check_seed, i);
+        n = 1 + static_cast<int>(seed % max_n);
+        p = ps[(seed >> 32) % std::size(ps)];
+    }
+
+    std::string describe() const {
+        std::ostringstream out {};
+        out << "n=" << n << " p=" << p << " seed=" << seed;
+        return out.str();
+    }
+};
+
+
+/**
+ * @brief the same graph, as adjacency lists
+*/
+static CSRGraph to_csr(const Graph & graph) {
+    std::vector<std::pair<int, int>> edge_list {};
+    for (std::size_t u = 0; u < graph.size(); ++u) {
+        for_each_bit(graph.adjacency().row(u), graph.adjacency().stride(), [&](std::size_t v) {
+            if (u < v) edge_list.emplace_back(u, v);
+        });
+    }
+    return {graph.size(), edge_list};
+}
+
+
+/**
+ * @brief checks if every pair of the nodes is connected
+*/
+static bool is_clique(const BitMatrix & adjacency, const std::vector<int> & nodes) {
+    for (std::size_t i = 0; i < nodes.size(); ++i) {
+        for (std::size_t j = i + 1; j < nodes.size(); ++j) {
+            if (!adjacency.test(nodes[i], nodes[j])) return false;
+        }
+    }
+    return true;
+}
+
+
+
+/**
+ * @brief number of triangles, from the common neighbors of the ends of every edge
+*/
+static std::uint64_t triangles(const BitMatrix & adjacency) {
+    std::uint64_t total = 0;
+    for (std::size_t u = 0; u < adjacency.size(); ++u) {
+        for_each_bit(adjacency.row(u), adjacency.stride(), [&](std::size_t v) {
+            total += BitMatrix::count_and(adjacency.row(u), adjacency.row(v), adjacency.stride());
+        });
+    }
+    return total / 6;  // every triangle is counted from its 6 ordered edges
+}
+
+
+/**
+ * @brief CLIQUE: the clique solvers agree with the size ω of a maximum clique (for every k up to ω + 1), on the
+ * matrix and CSR graphs. CLIQUE-COUNT finds cliques up to ω and not more, with the same count for both graphs and on
+ * 1 or 3 threads, its first counts are known (nodes, edges, triangles), and listing gives that many distinct k-cliques.
+ * Dense graphs have too many cliques of mid sizes to count, so k only goes up while there are at most `max_counted`
+ * cliques of k - 1 nodes, and cliques are only listed while there are at most that many
+*/
+static Check check_clique(std::uint64_t seed, int instances, int max_n) {
+    constexpr std::uint64_t max_counted = 20000;
+    Check check {"CLIQUE"};
+
+    for (int i = 0; i < instances; ++i) {
+        const Instance instance {seed, static_cast<std::uint64_t>(i), max_n};
+        const RandomUndirectedGraph graph {instance.n, instance.p, instance.seed};
+        const CSRGraph sparse = to_csr(graph);
+        check.instance(instance.describe());
+
+        const std::vector<int> maximum = graph.max_clique();
+        const int omega = maximum.size();
+        check.expect(is_clique(graph.adjacency(), maximum), true, "max_clique is a clique");
+        check.expect(static_cast<int>(graph.max_clique(0, 2).size()), omega, "max_clique on 2 threads");
+
+        const std::vector<int> colored = ColoringCliqueSearch {graph.adjacency()}.run();
+        check.expect(static_cast<int>(colored.size()), omega, "BBMC maximum clique size");
+        check.expect(is_clique(graph.adjacency(), colored), true, "BBMC maximum clique is a clique");
+
+        std::uint64_t edges = 0;
+        for (std::size_t u = 0; u < graph.size(); ++u) edges += graph.adjacency().count(u);
+        check.expect(graph.count_cliques(1), static_cast<std::uint64_t>(graph.size()), "CLIQUE-COUNT k=1 (nodes)");
+        check.expect(graph.count_cliques(2), edges / 2, "CLIQUE-COUNT k=2 (edges)");
+        check.expect(graph.count_cliques(3), triangles(graph.adjacency()), "CLIQUE-COUNT k=3 (triangles)");
+
+        bool counting = true;
+        for (int k = 1; k <= omega + 1; ++k) {
+            const bool expected = k <= omega;
+            const std::string what = " k=" + std::to_string(k);
+
+            check.expect(graph.k_clique(k), expected, "CLIQUE" + what);
+            check.expect(graph.k_clique_bt(k), expected, "CLIQUE-BT" + what);
+            check.expect(graph.k_clique_bbmc(k), expected, "CLIQUE-BBMC" + what);
+            check.expect(sparse.k_clique(k), expected, "CLIQUE --csr" + what);
+
+            const std::vector<int> found = graph.max_clique(k);  // stops at the first clique of k nodes or more
+            check.expect(static_cast<int>(found.size()) >= k && is_clique(graph.adjacency(), found), expected, "max_clique with target" + what);
+
+            if (!counting) continue;
+            const std::uint64_t count = graph.count_cliques(k);
+            check.expect(count > 0, expected, "CLIQUE-COUNT" + what);
+            check.expect(graph.count_cliques(k, 3), count, "CLIQUE-COUNT on 3 threads" + what);
+            check.expect(sparse.count_cliques(k), count, "CLIQUE-COUNT --csr" + what);
+            check.expect(sparse.count_cliques(k, 3), count, "CLIQUE-COUNT --csr on 3 threads" + what);
+
+            counting = count <= max_counted;
+            if (!counting) continue;  // too many to list
+
+            std::set<std::vector<int>> listed {};
+            std::mutex listed_lock;
+            bool all_cliques = true;
+            const std::uint64_t reported = graph.list_cliques(k, [&](std::span<const int> nodes) {
+                std::vector<int> clique (nodes.begin(), nodes.end());
+                std::lock_guard<std::mutex> guard {listed_lock};
+                all_cliques = all_cliques && static_cast<int>(clique.size()) == k && std::is_sorted(clique.begin(), clique.end()) && is_clique(graph.adjacency(), clique);
+                listed.insert(std::move(clique));
+            }, 3);
+            check.expect(reported, count, "CLIQUE-COUNT --cliques" + what);
+            check.expect(static_cast<std::uint64_t>(listed.size()), count, "CLIQUE-COUNT --cliques, distinct" + what);
+            check.expect(all_cliques, true, "CLIQUE-COUNT --cliques, sorted cliques of k nodes" + what);
+        }
+    }
+
+    return check;
+}
+
+
+
+
+/**
+ * @brief checks if an assignment (bit v - 1 = value of variable v) satisfies every clause
+*/
+static bool satisfies(const CNF & cnf, std::uint32_t assignment) {
+    for (std::size_t c = 0; c < cnf.size(); ++c) {
+        const auto clause = cnf.clause(c);
+        const bool any = std::any_of(clause.begin(), clause.end(), [&](int x) { return ((assignment >> (std::abs(x) - 1)) & 1) == (x > 0); });
+        if (!any) return false;
+    }
+    return true;
+}
+
+
+/**
+ * @brief SAT: CDCL and the clique reduction agree with trying every assignment, on random formulas of up to 10
+ * variables and 20 clauses of 1 to 4 literals (both satisfiable and not), and the model of CDCL satisfies them
+*/
+static Check check_sat(std::uint64_t seed, int instances, int) {
+    Check check {"SAT"};
+
+    for (int i = 0; i < instances; ++i) {
+        std::mt19937_64 rng {stream_seed(seed, i)};
+        const int variables = 1 + rng() % 10;
+        const int clauses = 1 + rng() % std::min(5 * variables, 20);  // the clique reduction is exponential in the clauses
+
+        CNF cnf {};
+        cnf.n_variables = variables;
+        for (int c = 0; c < clauses; ++c) {
+            const int length = 1 + rng() % 4;
+            for (int l = 0; l < length; ++l) {
+                const int v = 1 + rng() % variables;
+                cnf.literals.push_back(rng() % 2 ? v : -v);
+            }
+            cnf.end_clause();
+        }
+        check.instance("variables=" + std::to_string(variables) + " clauses=" + std::to_string(clauses) + " instance=" + std::to_string(i));
+
+        bool expected = false;
+        for (std::uint32_t a = 0; a < (std::uint32_t {1} << variables) && !expected; ++a) expected = satisfies(cnf, a);
+
+        CDCLSolver solver {cnf};
+        const bool result = solver.solve();
+        check.expect(result, expected, "SAT-CDCL");
+        check.expect(SatGraph {cnf}.satisfiable(), expected, "SAT-CLIQUE");
+
+        if (result) {
+            std::uint32_t model = 0;
+            for (int v = 1; v <= variables; ++v) model |= std::uint32_t {solver.value(v)} << (v - 1);
+            check.expect(satisfies(cnf, model), true, "SAT-CDCL model satisfies the formula");
+        }
+    }
+
+    return check;
+}
+
+
+
+
+/**
+ * @brief all-pairs distances of a graph, recomputed from scratch with Floyd-Warshall
+ * @param for_each_edge `for_each_edge(f)` calls `f(u, v, length)` for every (directed) edge
+*/
+template <typename F>
+static DistanceMatrix recompute(std::size_t n, F for_each_edge) {
+    DistanceMatrix distance (n);
+    for_each_edge([&](int u, int v, DistanceMatrix::dist_t length) { distance.at(u, v) = std::min(distance.at(u, v), length); });
+    floyd_warshall(distance);
+    return distance;
+}
+
+
+/**
+ * @brief compares every distance of two matrices
+*/
+static void expect_distances(Check & check, const DistanceMatrix & result, const DistanceMatrix & expected, const std::string & what) {
+    check.expect(result.size(), expected.size(), what + " size");
+    for (std::size_t u = 0; u < std::min(result.size(), expected.size()); ++u) {
+        for (std::size_t v = 0; v < expected.size(); ++v) {
+            check.expect(result.at(u, v), expected.at(u, v), what + " (" + std::to_string(u) + ", " + std::to_string(v) + ")");
+        }
+    }
+}
+
+
+/**
+ * @brief DISTANCES: the matrix kept up to date by insert_node & insert_edge matches Floyd-Warshall on the final graph,
+ * for directed graphs with random lengths (built node by node, with a third of the edges added afterwards), and so
+ * do the distances (and edge count) of a Graph after add_node & add_edge. The graphs go past 64 nodes, so the matrix grows
+*/
+static Check check_distances(std::uint64_t seed, int instances, int max_n) {
+    Check check {"DISTANCES"};
+    using dist_t = DistanceMatrix::dist_t;
+
+    for (int i = 0; i < instances; ++i) {
+        const Instance instance {seed, static_cast<std::uint64_t>(i), 3 * max_n};
+        const int n = instance.n;
+        std::mt19937_64 rng {instance.seed};
+        std::bernoulli_distribution edge {instance.p};
+        check.instance(instance.describe());
+
+        // directed, lengths in [0, 20]
+        struct Edge { int u, v; dist_t length; bool later; };
+        std::vector<Edge> edges {};
+        for (int u = 0; u < n; ++u) {
+            for (int v = 0; v < n; ++v) {
+                if (u != v && edge(rng)) edges.push_back({u, v, static_cast<dist_t>(rng() % 21), rng() % 3 == 0});
+            }
+        }
+
+        DistanceMatrix incremental {};
+        for (int k = 0; k < n; ++k) {
+            std::vector<weighted_edge_t> in {}, out {};
+            for (auto & e : edges) {
+                if (e.later || std::max(e.u, e.v) != k) continue;
+                if (e.v == k) in.emplace_back(e.u, e.length);
+                else out.emplace_back(e.v, e.length);
+            }
+            insert_node(incremental, in, out);
+        }
+        for (auto & e : edges) {
+            if (e.later) insert_edge(incremental, e.u, e.v, e.length);
+        }
+
+        expect_distances(check, incremental, recompute(n, [&](auto f) { for (auto & e : edges) f(e.u, e.v, e.length); }), "insert_node & insert_edge");
+
+        // Graph: half the nodes at first, then the rest and some edges, with the distances already computed
+        Graph graph {RandomUndirectedGraph {std::max(n / 2, 1), instance.p, instance.seed}};
+        graph.distances();
+        for (int k = graph.size(); k < n; ++k) {
+            std::vector<int> adjacent {};
+            for (int u = 0; u < k; ++u) {
+                if (edge(rng)) adjacent.push_back(u);
+            }
+            graph.add_node(adjacent);
+            if (k > 1) graph.add_edge(rng() % k, rng() % k);
+        }
+
+        const DistanceMatrix expected = recompute(graph.size(), [&](auto f) {
+            for (std::size_t u = 0; u < graph.size(); ++u) {
+                for_each_bit(graph.adjacency().row(u), graph.adjacency().stride(), [&](std::size_t v) { f(u, v, 1); });
+            }
+        });
+        expect_distances(check, graph.distances(), expected, "Graph::add_node & add_edge");
+
+        std::size_t degrees = 0;
+        for (std::size_t u = 0; u < graph.size(); ++u) degrees += graph.degree(u);
+        check.expect(graph.edge_count(), degrees, "Graph::edge_count after add_node & add_edge");
+    }
+
+    return check;
+}
+
+
+
+
+/**
+ * @brief PATH: the PATH solvers (matrix and CSR) agree with BFS on random queries, and so do the batched queries of
+ * path_many (multi-source BFS). The nodes reached from a list of sources (reachable_from) are the ones in their
+ * components. The graphs go up to 10 * max_n nodes, around the connectivity threshold, so there's more than one
+ * batch of 256 sources
+*/
+static Check check_path(std::uint64_t seed, int instances, int max_n) {
+    Check check {"PATH"};
+
+    for (int i = 0; i < instances; ++i) {
+        Instance instance {seed, static_cast<std::uint64_t>(i), 10 * max_n};
+        instance.p = std::min(1.0f, instance.p * 4 / instance.n);  // up to 4 neighbors per node on average
+        const int n = instance.n;
+        const RandomUndirectedGraph graph {n, instance.p, instance.seed};
+        const CSRGraph sparse = to_csr(graph);
+        std::mt19937_64 rng {instance.seed};
+        check.instance(instance.describe());
+
+        // a few queries from every node, in random order
+        std::vector<std::pair<int, int>> queries {};
+        for (int u = 0; u < n; ++u) {
+            for (int q = 0; q < 3; ++q) queries.emplace_back(u, rng() % n);
+        }
+        std::shuffle(queries.begin(), queries.end(), rng);
+
+        const std::vector<bool> batched = graph.path_many(queries);
+        const std::vector<bool> batched_sparse = sparse.path_many(queries);
+        for (std::size_t q = 0; q < queries.size(); ++q) {
+            const auto [u, v] = queries[q];
+            const bool expected = graph.path_bfs(u, v);
+            const std::string what = " (" + std::to_string(u) + ", " + std::to_string(v) + ")";
+
+            check.expect(graph.path_dfs(u, v), expected, "PATH-DFS" + what);
+            check.expect(graph.path_fw(u, v), expected, "PATH-FW" + what);
+            check.expect(graph.path_tc(u, v), expected, "PATH-TC" + what);
+            check.expect(graph.path_uf(u, v), expected, "PATH-UF" + what);
+            check.expect(sparse.path_dfs(u, v), expected, "PATH-DFS --csr" + what);
+            check.expect(sparse.path_bfs(u, v), expected, "PATH-BFS --csr" + what);
+            check.expect(sparse.path_fw(u, v), expected, "PATH-FW --csr" + what);
+            check.expect(sparse.path_tc(u, v), expected, "PATH-TC --csr" + what);
+            check.expect(sparse.path_uf(u, v), expected, "PATH-UF --csr" + what);
+            check.expect(static_cast<bool>(batched[q]), expected, "path_many" + what);
+            check.expect(static_cast<bool>(batched_sparse[q]), expected, "path_many --csr" + what);
+        }
+
+        // random sources (repeated ones too), a row of every node each: the first wrong node of a row, if any
+        std::vector<int> sources (n + n / 2);
+        for (auto & s : sources) s = rng() % n;
+        const ReachableSets reached = graph.reachable_from(sources);
+        const ReachableSets reached_sparse = sparse.reachable_from(sources);
+        auto first_wrong = [&](const ReachableSets & rows, std::size_t s) {
+            for (int v = 0; v < n; ++v) {
+                if (rows.reachable(s, v) != graph.path_uf(sources[s], v)) return v;
+            }
+            return -1;
+        };
+        for (std::size_t s = 0; s < sources.size(); ++s) {
+            const std::string what = " from " + std::to_string(sources[s]) + ", first wrong node";
+            check.expect(first_wrong(reached, s), -1, "reachable_from" + what);
+            check.expect(first_wrong(reached_sparse, s), -1, "reachable_from --csr" + what);
+        }
+    }
+
+    return check;
+}
+
+
+/**
+ * @brief FIXED: the FixedGraph solvers (PATH-FIXED and CLIQUE-FIXED) agree with BFS and with the size ω of a maximum
+ * clique, for graphs of up to 256 nodes (around the 64 and 128 node boundaries of `with_fixed_graph` too). They're
+ * also copied from a matrix with rows wider than their own (that's kept from a bigger size), which gives the same
+ * answers, and a graph too big for a FixedGraph is refused
+*/
+static Check check_fixed(std::uint64_t seed, int instances, int max_n) {
+    static constexpr int boundaries[] = {63, 64, 65, 127, 128, 129, 255, 256};
+    Check check {"FIXED"};
+
+    for (int i = 0; i < instances; ++i) {
+        Instance instance {seed, static_cast<std::uint64_t>(i), 256};
+        if (static_cast<std::size_t>(i) < std::size(boundaries)) instance.n = boundaries[i];
+        if (instance.n > max_n) instance.p = std::min(instance.p, 0.3f);  // backtracking is exponential in ω
+        const int n = instance.n;
+        const RandomUndirectedGraph graph {n, instance.p, instance.seed};
+        std::mt19937_64 rng {instance.seed};
+        check.instance(instance.describe());
+
+        // the same graph, in rows of 512 nodes
+        BitMatrix wide {512};
+        wide.resize(n);
+        for (int u = 0; u < n; ++u) {
+            for_each_bit(graph.adjacency().row(u), graph.adjacency().stride(), [&](std::size_t v) { wide.set(u, v); });
+        }
+
+        const int omega = static_cast<int>(graph.max_clique().size());
+        for (const BitMatrix * adjacency : {&graph.adjacency(), static_cast<const BitMatrix *>(&wide)}) {
+            const std::string rows = adjacency == &wide ? ", wide rows" : "";
+
+            const bool fits = with_fixed_graph(*adjacency, [&](const auto & fixed) {
+                check.expect(fixed.size(), static_cast<std::size_t>(n), "FixedGraph size" + rows);
+                for (int q = 0; q < 3 * n; ++q) {
+                    const int u = rng() % n, v = rng() % n;
+                    check.expect(fixed.path(u, v), graph.path_bfs(u, v), "PATH-FIXED (" + std::to_string(u) + ", " + std::to_string(v) + ")" + rows);
+                }
+                for (int k = 1; k <= omega + 1; ++k) {
+                    check.expect(fixed.k_clique(k), k <= omega, "CLIQUE-FIXED k=" + std::to_string(k) + rows);
+                }
+            });
+            check.expect(fits, true, "with_fixed_graph" + rows);
+        }
+    }
+
+    // one node too many
+    bool refused = false;
+    try {
+        FixedGraph<64> {BitMatrix {65}};
+    }
+    catch (const std::invalid_argument &) {
+        refused = true;
+    }
+    check.expect(refused, true, "FixedGraph<64> of 65 nodes");
+    check.expect(with_fixed_graph(BitMatrix {257}, [](const auto &) { }), false, "with_fixed_graph of 257 nodes");
+
+    return check;
+}
+
+
+
+
+/* CLI */
+
+DEFINE_string(check, "CLIQUE,SAT,DISTANCES,PATH,FIXED", "comma-separated checks to run (CLIQUE, SAT, DISTANCES, PATH, FIXED)");
+DEFINE_int(instances, 200, "random instances per check");
+DEFINE_int(max_n, 40, "maximum size of the random graphs (3 times that for DISTANCES and 10 for PATH, to fill more than one batch)");
+DEFINE_int(seed, 1, "seed of the random instances");
+DEFINE_bool(help, false, "show a list of command-line options");
+
+
+
+int main(int argc, char* argv[]) {
+
+    // parse cli
+    REGISTER_FLAG(argc, argv, check);
+    REGISTER_FLAG(argc, argv, instances);
+    REGISTER_FLAG(argc, argv, max_n);
+    REGISTER_FLAG(argc, argv, seed);
+    REGISTER_FLAG(argc, argv, help);
+
+    if (FLAG_help) {
+        std::cout << "Usage\n  " << argv[0] << " [options]";
+        std::cout << "\n\nOPTIONS";
+        flaghelp();
+        std::cout << "\nCompares the algorithms that answer the same question on seeded random instances, outputting a JSON line per check. Returns 1 if any result differs\n";
+
+        return 0;
+    }
+
+    const std::vector<std::pair<std::string, std::function<Check(std::uint64_t, int, int)>>> checks {
+        {"CLIQUE", check_clique},
+        {"SAT", check_sat},
+        {"DISTANCES", check_distances},
+        {"PATH", check_path},
+        {"FIXED", check_fixed},
+    };
+
+    bool passed = true;
+    std::istringstream names {FLAG_check};
+    for (std::string name {}; std::getline(names, name, ',');) {
+        std::transform(name.begin(), name.end(), name.begin(), ::toupper);
+
+        auto it = std::find_if(checks.begin(), checks.end(), [&](auto & c) { return c.first == name; });
+        if (it == checks.end()) {
+            std::cerr << "Unknown check '" << name << "'\n";
+            return -1;
+        }
+
+        const Check result = it->second(static_cast<std::uint64_t>(FLAG_seed), FLAG_instances, std::max(FLAG_max_n, 1));
+        std::cout << result << std::endl;
+        passed = passed && result.passed();
+    }
+
+    return passed ? 0 : 1;
+}
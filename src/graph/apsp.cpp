@@ -0,0 +1,172 @@
+#include "apsp.hpp"
+#include "parallel.hpp"
+#include "counters.hpp"
+
+#include <barrier>
+#include <thread>
+#include <vector>
+#include <algorithm>
+
+
+
+DistanceMatrix::DistanceMatrix(std::size_t n) :
+    n {n},
+    row_stride {(n + block - 1) / block * block},
+    dist (row_stride * row_stride, infinity)
+{
+    P2_COUNT(bytes_allocated, dist.size() * sizeof(dist_t));
+
+    // padding nodes are isolated, so they don't change any path
+    for (std::size_t i = 0; i < row_stride; ++i) at(i, i) = 0;
+}
+
+
+void DistanceMatrix::add_node() {
+    if (n == row_stride) {
+        // another block of padding: rows are copied to the wider stride, the new entries are isolated nodes
+        const std::size_t nodes = n;
+        DistanceMatrix grown (nodes + block);
+        for (std::size_t u = 0; u < nodes; ++u) std::copy_n(row(u), nodes, grown.row(u));
+        *this = std::move(grown);
+        n = nodes;
+    }
+    ++n;
+}
+
+
+
+/**
+ * @brief c = min(c, a + b) for one tile, in the (min, +) semiring: c[i][j] = min(c[i][j], a[i][k] + b[k][j]).
+ * The tiles may overlap (phases 1 & 2): with k as the outer loop, this is Floyd-Warshall restricted to the tile.
+ * The inner loop has no branches, so it's vectorized
+*/
+static void min_plus(DistanceMatrix::dist_t * c, const DistanceMatrix::dist_t * a, const DistanceMatrix::dist_t * b, std::size_t stride) {
+    constexpr std::size_t B = DistanceMatrix::block;
+
+    for (std::size_t k = 0; k < B; ++k) {
+        const DistanceMatrix::dist_t * b_k = b + k * stride;
+
+        for (std::size_t i = 0; i < B; ++i) {
+            const DistanceMatrix::dist_t a_ik = a[i * stride + k];
+            DistanceMatrix::dist_t * c_i = c + i * stride;
+
+            for (std::size_t j = 0; j < B; ++j) {
+                c_i[j] = std::min(c_i[j], a_ik + b_k[j]);
+            }
+        }
+    }
+}
+
+
+void floyd_warshall(DistanceMatrix & distance, unsigned threads) {
+    constexpr std::size_t B = DistanceMatrix::block;
+    const std::size_t stride = distance.stride();
+    const std::size_t tiles = stride / B;  // tiles per row
+
+    auto tile = [&](std::size_t ti, std::size_t tj) { return distance.row(ti * B) + tj * B; };
+
+    // every pivot relaxes every pair (counted here: the tiles may run on other threads)
+    P2_COUNT(nodes_expanded, stride);
+    P2_COUNT(edges_scanned, stride * stride * stride);
+
+    // a thread per 4 rows of tiles at most, otherwise syncing the phases costs more than it saves
+    if (threads == 0) threads = default_threads();
+    threads = static_cast<unsigned>(std::max<std::size_t>(1, std::min<std::size_t>(threads, tiles / 4)));
+
+    // every thread takes its share of each phase, then waits for the others
+    std::barrier sync (threads);
+    auto worker = [&](unsigned t) {
+        for (std::size_t tk = 0; tk < tiles; ++tk) {
+            // phase 1: diagonal tile, only depends on itself
+            if (t == 0) min_plus(tile(tk, tk), tile(tk, tk), tile(tk, tk), stride);
+            sync.arrive_and_wait();
+
+            // phase 2: tiles in row tk & column tk, only depend on themselves and the diagonal tile
+            for (std::size_t i = t; i < 2 * tiles; i += threads) {
+                const std::size_t tj = i / 2;
+                if (tj == tk) continue;
+
+                if (i % 2 == 0) min_plus(tile(tk, tj), tile(tk, tk), tile(tk, tj), stride);
+                else min_plus(tile(tj, tk), tile(tj, tk), tile(tk, tk), stride);
+            }
+            sync.arrive_and_wait();
+
+            // phase 3: every other tile, from its row & column tiles (independent, rows of tiles dealt round-robin)
+            for (std::size_t ti = t; ti < tiles; ti += threads) {
+                if (ti == tk) continue;
+                for (std::size_t tj = 0; tj < tiles; ++tj) {
+                    if (tj == tk) continue;
+                    min_plus(tile(ti, tj), tile(ti, tk), tile(tk, tj), stride);
+                }
+            }
+            sync.arrive_and_wait();
+        }
+    };
+
+    std::vector<std::jthread> pool {};
+    for (unsigned t = 1; t < threads; ++t) pool.emplace_back(worker, t);
+    worker(0);
+}
+
+
+
+/**
+ * @brief dist[x][y] = min(dist[x][y], dist[x][column] + length + to[y]) for every pair, skipping the rows that
+ * don't reach `column`. `to` is a copy, so the inner loop doesn't alias the matrix and is vectorized
+*/
+static void relax_through(DistanceMatrix & distance, std::size_t column, DistanceMatrix::dist_t length, const std::vector<DistanceMatrix::dist_t> & to) {
+    using dist_t = DistanceMatrix::dist_t;
+    const std::size_t n = distance.size();
+
+    P2_COUNT(edges_scanned, n * n);
+    for (std::size_t x = 0; x < n; ++x) {
+        dist_t * d_x = distance.row(x);
+        if (d_x[column] >= DistanceMatrix::infinity) continue;
+        const dist_t via = d_x[column] + length;
+        if (via >= DistanceMatrix::infinity) continue;
+
+        for (std::size_t y = 0; y < n; ++y) {
+            d_x[y] = std::min(d_x[y], via + to[y]);
+        }
+    }
+}
+
+
+void insert_node(DistanceMatrix & distance, std::span<const weighted_edge_t> in, std::span<const weighted_edge_t> out) {
+    using dist_t = DistanceMatrix::dist_t;
+
+    distance.add_node();
+    const std::size_t n = distance.size();
+    const std::size_t k = n - 1;  // the new node
+    P2_COUNT(nodes_expanded, 1);
+
+    // to the new node: the shortest path x -> u plus the edge u -> k (a shortest path doesn't go through k before its end)
+    for (auto & [u, length] : in) {
+        assert(static_cast<std::size_t>(u) < k && length >= 0);
+        for (std::size_t x = 0; x < k; ++x) {
+            const dist_t d = distance.at(x, u);
+            if (d < DistanceMatrix::infinity) distance.at(x, k) = std::min(distance.at(x, k), d + length);
+        }
+    }
+
+    // from the new node: the edge k -> v plus the shortest path v -> y
+    std::vector<dist_t> from (n, DistanceMatrix::infinity);
+    from[k] = 0;
+    for (auto & [v, length] : out) {
+        assert(static_cast<std::size_t>(v) < k && length >= 0);
+        const dist_t * d_v = distance.row(v);
+        for (std::size_t y = 0; y < k; ++y) from[y] = std::min(from[y], std::min(d_v[y] + length, DistanceMatrix::infinity));
+    }
+    P2_COUNT(edges_scanned, (in.size() + out.size()) * n);
+
+    // every other pair, through the new node (row k is still infinity, and gets `from` itself)
+    relax_through(distance, k, 0, from);
+}
+
+
+void insert_edge(DistanceMatrix & distance, int u, int v, DistanceMatrix::dist_t length) {
+    assert(static_cast<std::size_t>(u) < distance.size() && static_cast<std::size_t>(v) < distance.size() && length >= 0);
+
+    const std::vector<DistanceMatrix::dist_t> from_v (distance.row(v), distance.row(v) + distance.size());
+    relax_through(distance, u, length, from_v);
+}
@@ -0,0 +1,112 @@
+#ifndef APSP_HPP
+#define APSP_HPP
+
+
+#include <vector>
+#include <span>
+#include <utility>
+#include <cstddef>
+#include <limits>
+#include <cassert>
+
+#include "bitmatrix.hpp"
+
+
+
+/**
+ * @brief n x n matrix of path lengths, stored contiguously. Rows are padded to a multiple of `block`
+ * so the all-pairs engine can work on whole tiles
+*/
+class DistanceMatrix {
+    public:
+        using dist_t = int;
+
+        // no path. Half the range, so adding two distances never overflows
+        static constexpr dist_t infinity {std::numeric_limits<dist_t>::max() / 2};
+
+        static constexpr std::size_t block = 64;  // tile size (64 x 64 ints = 16 KiB)
+
+        DistanceMatrix(): n {0}, row_stride {0}, dist {} { }
+
+        /**
+        * @brief creates a matrix with every distance set to infinity, except the diagonal (0)
+        */
+        explicit DistanceMatrix(std::size_t n);
+
+
+        /**
+        * @brief number of nodes
+        */
+        std::size_t size() const { return n; }
+
+        /**
+        * @brief number of entries per row (a multiple of `block`)
+        */
+        std::size_t stride() const { return row_stride; }
+
+        /**
+        * @brief appends an isolated node (infinity to and from every other node). The rows are padded, so this only
+        * moves the matrix when the padding runs out, every `block` nodes
+        */
+        void add_node();
+
+
+        dist_t & at(std::size_t u, std::size_t v) { return dist[u * row_stride + v]; }
+
+        dist_t at(std::size_t u, std::size_t v) const { return dist[u * row_stride + v]; }
+
+        dist_t * row(std::size_t u) { return dist.data() + u * row_stride; }
+
+        const dist_t * row(std::size_t u) const { return dist.data() + u * row_stride; }
+
+        /**
+        * @brief checks if there is a path from u to v
+        */
+        bool reachable(std::size_t u, std::size_t v) const { return at(u, v) < infinity; }
+
+
+    private:
+        std::size_t n;
+        std::size_t row_stride;
+        std::vector<dist_t, AlignedAllocator<dist_t>> dist;
+};
+
+
+
+/**
+ * @brief computes the shortest path between every pair of nodes, given the edge lengths (infinity = no edge),
+ * using a tiled Floyd-Warshall. Each round finishes the diagonal tile, then the tiles in its row & column,
+ * then every other tile, spreading the last two phases over `threads` threads (0 = one per core). The threads
+ * are started once and meet after every phase, and there's at most one per 4 rows of tiles.
+ * Cost: O(n^3) time, no extra memory
+*/
+void floyd_warshall(DistanceMatrix & distance, unsigned threads = 1);
+
+
+
+/*
+ * Incremental updates: the matrix holds the shortest paths of a graph (non-negative lengths), and is kept that way
+ * as the graph grows, in O(n^2) per change instead of the O(n^3) of recomputing it. Growing a graph from 1 to N
+ * nodes costs O(N^3) in total.
+*/
+
+using weighted_edge_t = std::pair<int, DistanceMatrix::dist_t>;  // (node, length)
+
+
+/**
+ * @brief appends a node with edges from the nodes in `in` and to the nodes in `out` (the same ones for an undirected
+ * graph). Its distances come from the last edge of every path into it and the first edge of every path out, then
+ * every other pair gets the paths through it. O(n^2)
+*/
+void insert_node(DistanceMatrix & distance, std::span<const weighted_edge_t> in, std::span<const weighted_edge_t> out);
+
+
+/**
+ * @brief adds an edge from u to v (call it again from v to u for an undirected graph): every pair (x, y) gets the
+ * path x -> u -> v -> y. O(n^2)
+*/
+void insert_edge(DistanceMatrix & distance, int u, int v, DistanceMatrix::dist_t length);
+
+
+
+#endif
@@ -0,0 +1,186 @@
+#include "bbmc.hpp"
+#include "clique.hpp"
+#include "counters.hpp"
+
+#include <algorithm>
+
+
+
+ColoringCliqueSearch::ColoringCliqueSearch(const BitMatrix & adjacency, int target) :
+    adj (adjacency.size()),
+    label {degeneracy_order(adjacency)},
+    n_words {adj.stride()},
+    target {static_cast<std::size_t>(std::max(target, 0))},
+    current {},
+    best {},
+    levels {},
+    classes {},
+    uncolored (n_words),
+    available (n_words)
+{
+    // relabel: densest part of the graph first, so it gets the lowest colors
+    std::reverse(label.begin(), label.end());
+
+    std::vector<int> position (label.size());
+    for (std::size_t i = 0; i < label.size(); ++i) position[label[i]] = i;
+
+    for (std::size_t i = 0; i < label.size(); ++i) {
+        for_each_bit(adjacency.row(label[i]), adjacency.stride(), [&](std::size_t u) { adj.set(i, position[u]); });
+    }
+}
+
+
+std::vector<int> ColoringCliqueSearch::run() {
+    const std::size_t n = adj.size();
+    current.clear();
+    best.clear();
+    if (n == 0) return best;
+
+    // at most one level per node. Reserving them all keeps references to them valid while recursing
+    levels.clear();
+    levels.reserve(n + 1);
+    levels.push_back({std::vector<word_t>(n_words, 0), {}, {}});
+    for (std::size_t v = 0; v < n; ++v) levels[0].candidates[v / BitMatrix::word_bits] |= word_t {1} << (v % BitMatrix::word_bits);
+
+    expand(0);
+
+    std::vector<int> clique {};
+    for (auto & v : best) clique.push_back(label[v]);
+    std::sort(clique.begin(), clique.end());
+
+    return clique;
+}
+
+
+void ColoringCliqueSearch::color(std::size_t depth, std::size_t min_color) {
+    Level & level = levels[depth];
+    level.nodes.clear();
+    level.colors.clear();
+
+    std::copy_n(level.candidates.data(), n_words, uncolored.data());
+    const std::size_t low_classes = min_color > 0 ? min_color - 1 : 0;  // classes never branched on
+
+    // build one color class at a time: repeatedly take the first available node, and drop its neighbors
+    std::size_t k = 0;
+    while (BitMatrix::count(uncolored.data(), n_words) > 0) {
+        if (classes.size() < (k + 1) * n_words) classes.resize((k + 1) * n_words);
+        word_t * cls = classes.data() + k * n_words;
+        std::fill_n(cls, n_words, 0);
+        std::copy_n(uncolored.data(), n_words, available.data());
+
+        for (std::size_t w = 0; w < n_words; ++w) {
+            while (available[w]) {
+                const std::size_t v = w * BitMatrix::word_bits + std::countr_zero(available[w]);
+                const word_t bit = available[w] & -available[w];
+
+                uncolored[w] &= ~bit;
+                cls[w] |= bit;
+
+                const word_t * row = adj.row(v);
+                available[w] &= ~bit;
+                for (std::size_t x = w; x < n_words; ++x) available[x] &= ~row[x];
+            }
+        }
+
+        // nodes that would be branched on: try to move them down to a class that isn't
+        if (k >= low_classes && low_classes >= 2) {
+            for_each_bit(cls, n_words, [&](std::size_t v) {
+                if (renumber(v, low_classes)) cls[v / BitMatrix::word_bits] &= ~(word_t {1} << (v % BitMatrix::word_bits));
+            });
+        }
+
+        ++k;
+    }
+
+    // branching nodes, by increasing color (classes emptied by the re-numbering don't count)
+    std::size_t c = 0;
+    for (std::size_t i = 0; i < k; ++i) {
+        const word_t * cls = classes.data() + i * n_words;
+        if (BitMatrix::count(cls, n_words) == 0) continue;
+        ++c;
+        if (c < min_color) continue;
+
+        for_each_bit(cls, n_words, [&](std::size_t v) {
+            level.nodes.push_back(v);
+            level.colors.push_back(c);
+        });
+    }
+}
+
+
+bool ColoringCliqueSearch::renumber(std::size_t v, std::size_t low_classes) {
+    const word_t * row_v = adj.row(v);
+
+    for (std::size_t c1 = 0; c1 < low_classes; ++c1) {
+        word_t * class_1 = classes.data() + c1 * n_words;
+        if (BitMatrix::count_and(class_1, row_v, n_words) != 1) continue;
+
+        // w: the only neighbor of v in class c1
+        std::size_t w = 0;
+        for (std::size_t x = 0; x < n_words; ++x) {
+            if (class_1[x] & row_v[x]) w = x * BitMatrix::word_bits + std::countr_zero(class_1[x] & row_v[x]);
+        }
+
+        for (std::size_t c2 = c1 + 1; c2 < low_classes; ++c2) {
+            word_t * class_2 = classes.data() + c2 * n_words;
+            if (BitMatrix::count_and(class_2, adj.row(w), n_words) != 0) continue;
+
+            // w to c2, v to c1
+            class_1[w / BitMatrix::word_bits] &= ~(word_t {1} << (w % BitMatrix::word_bits));
+            class_2[w / BitMatrix::word_bits] |= word_t {1} << (w % BitMatrix::word_bits);
+            class_1[v / BitMatrix::word_bits] |= word_t {1} << (v % BitMatrix::word_bits);
+            return true;
+        }
+    }
+
+    return false;
+}
+
+
+void ColoringCliqueSearch::expand(std::size_t depth) {
+    if (levels.size() < depth + 2) {
+        levels.push_back({std::vector<word_t>(n_words, 0), {}, {}});
+        P2_COUNT(bytes_allocated, n_words * sizeof(word_t));
+    }
+    P2_COUNT(nodes_expanded, 1);
+    P2_DEPTH(current.size());
+
+    Level & level = levels[depth];
+    word_t * P = level.candidates.data();
+    word_t * next_P = levels[depth + 1].candidates.data();
+
+    // size a clique must exceed to be worth exploring (with a target, smaller cliques don't matter)
+    auto bound = [this]() { return std::max(best.size(), target > 0 ? target - 1 : 0); };
+
+    // colors needed to beat it
+    const std::size_t min_color = bound() >= current.size() ? bound() - current.size() + 1 : 1;
+    color(depth, min_color);
+
+    // highest colors first
+    for (std::size_t i = level.nodes.size(); i-- > 0;) {
+        if (current.size() + level.colors[i] <= bound()) {
+            P2_COUNT(pruned, 1);
+            return;
+        }
+
+        const std::size_t v = level.nodes[i];
+        const word_t * row = adj.row(v);
+
+        std::size_t next_candidates = 0;
+        for (std::size_t w = 0; w < n_words; ++w) {
+            next_P[w] = P[w] & row[w];
+            next_candidates += std::popcount(next_P[w]);
+        }
+
+        current.push_back(v);
+        if (next_candidates == 0) {
+            if (current.size() > bound()) best = current;
+        }
+        else expand(depth + 1);
+        current.pop_back();
+
+        if (done()) return;
+
+        P[v / BitMatrix::word_bits] &= ~(word_t {1} << (v % BitMatrix::word_bits));
+    }
+}
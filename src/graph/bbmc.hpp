@@ -0,0 +1,75 @@
+#ifndef BBMC_HPP
+#define BBMC_HPP
+
+
+#include <vector>
+#include <cstddef>
+
+#include "bitmatrix.hpp"
+
+
+
+/**
+ * @brief maximum clique search using branch and bound with greedy coloring bounds (BBMC / MCS style)
+ *
+ * Nodes are first relabeled in reverse degeneracy order (densest first). At every step the candidates are
+ * colored greedily, a whole color class at a time with bitset operations: a clique can't have more nodes
+ * than colors, so branches whose clique + number of colors can't beat the best are pruned. Only nodes
+ * with a color high enough to beat the best are branched on; the rest are kept as candidates only.
+ * High-colored nodes are moved to a lower class when that takes a single swap (MCS re-numbering),
+ * which tightens the bound.
+*/
+class ColoringCliqueSearch {
+    public:
+        using word_t = BitMatrix::word_t;
+
+        /**
+        * @param target stop as soon as a clique of `target` nodes is found (0 = find a maximum clique)
+        */
+        explicit ColoringCliqueSearch(const BitMatrix & adjacency, int target = 0);
+
+        /**
+        * @brief runs the search
+        * @return nodes of the clique (original labels), sorted. With a target, it has fewer nodes (and isn't necessarily maximum) if there is no clique of `target` nodes
+        */
+        std::vector<int> run();
+
+
+    private:
+        struct Level {
+            std::vector<word_t> candidates;  // P
+            std::vector<int> nodes;  // branching nodes, by increasing color
+            std::vector<int> colors;
+        };
+
+        BitMatrix adj;  // relabeled adjacency
+        std::vector<int> label;  // original label of every node
+        const std::size_t n_words;
+        const std::size_t target;
+
+        std::vector<int> current;
+        std::vector<int> best;
+
+        std::vector<Level> levels;
+        std::vector<word_t> classes;  // color classes of the current coloring, n_words each
+        std::vector<word_t> uncolored;
+        std::vector<word_t> available;
+
+        bool done() const { return target > 0 && best.size() >= target; }
+
+        /**
+        * @brief colors the candidates of level `depth`, keeping the nodes with color >= `min_color` to branch on
+        */
+        void color(std::size_t depth, std::size_t min_color);
+
+        /**
+        * @brief tries to move v from its class to class c1 < `low_classes`, moving its only neighbor there to another low class
+        */
+        bool renumber(std::size_t v, std::size_t low_classes);
+
+        void expand(std::size_t depth);
+};
+
+
+
+#endif
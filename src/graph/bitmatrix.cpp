@@ -0,0 +1,83 @@
+#include "bitmatrix.hpp"
+
+#include <algorithm>
+
+
+
+void BitMatrix::clear() {
+    words.clear();
+    n = 0;
+    row_stride = 0;  // the next rows start narrow again
+}
+
+
+void BitMatrix::reserve(std::size_t new_n) {
+    if (words_for(new_n) > row_stride) relayout(words_for(new_n));
+    words.reserve(new_n * row_stride);
+}
+
+
+void BitMatrix::resize(std::size_t new_n) {
+    if (new_n == 0) return clear();
+
+    const std::size_t needed = words_for(new_n);
+
+    if (needed > row_stride) {  // rows don't fit, widen them to (at least) twice the width
+        relayout(std::max(needed, 2 * row_stride));
+    }
+    else if (new_n < n) {  // clear the columns that are dropped
+        for (std::size_t i = 0; i < new_n; ++i) {
+            for (std::size_t j = new_n; j < n; ++j) reset(i, j);
+        }
+    }
+
+    words.resize(new_n * row_stride, 0);
+    n = new_n;
+}
+
+
+void BitMatrix::assign(std::size_t new_n, const word_t * rows) {
+    row_stride = words_for(new_n);
+    words.assign(rows, rows + new_n * row_stride);
+    n = new_n;
+}
+
+
+void BitMatrix::relayout(std::size_t new_stride) {
+    std::vector<word_t, AlignedAllocator<word_t>> new_words (n * new_stride, 0);
+
+    for (std::size_t i = 0; i < n; ++i) {
+        std::copy_n(row(i), row_stride, new_words.data() + i * new_stride);
+    }
+
+    words = std::move(new_words);
+    row_stride = new_stride;
+}
+
+
+bool BitMatrix::covers(std::size_t i, const word_t * mask) const {
+    const word_t * r = row(i);
+    word_t missing = 0;
+    for (std::size_t k = 0; k < row_stride; ++k) {
+        missing |= mask[k] & ~r[k];
+    }
+    return missing == 0;
+}
+
+
+std::size_t BitMatrix::count(const word_t * w, std::size_t n_words) {
+    std::size_t c = 0;
+    for (std::size_t k = 0; k < n_words; ++k) {
+        c += std::popcount(w[k]);
+    }
+    return c;
+}
+
+
+std::size_t BitMatrix::count_and(const word_t * a, const word_t * b, std::size_t n_words) {
+    std::size_t c = 0;
+    for (std::size_t k = 0; k < n_words; ++k) {
+        c += std::popcount(a[k] & b[k]);
+    }
+    return c;
+}
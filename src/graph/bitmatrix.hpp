@@ -0,0 +1,225 @@
+#ifndef BITMATRIX_HPP
+#define BITMATRIX_HPP
+
+
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+#include <array>
+#include <new>
+#include <bit>
+
+
+
+/**
+ * @brief allocator returning blocks aligned to a cache line, so padded rows can be loaded with aligned SIMD instructions
+*/
+template <typename T, std::size_t Align = 64>
+struct AlignedAllocator {
+    using value_type = T;
+
+    template <typename U>
+    struct rebind { using other = AlignedAllocator<U, Align>; };
+
+    AlignedAllocator() = default;
+
+    template <typename U>
+    AlignedAllocator(const AlignedAllocator<U, Align> &) { }
+
+    T * allocate(std::size_t n) {
+        return static_cast<T *>(::operator new(n * sizeof(T), std::align_val_t {Align}));
+    }
+
+    void deallocate(T * p, std::size_t) { ::operator delete(p, std::align_val_t {Align}); }
+
+    template <typename U>
+    bool operator == (const AlignedAllocator<U, Align> &) const { return true; }
+};
+
+
+
+/**
+ * @brief dense n x n bit matrix, stored contiguously row after row
+ *
+ * Each row takes `stride()` 64-bit words, padded to a multiple of `simd_words` so that whole rows
+ * can be processed with 256-bit vector operations. The bits past `size()` are always 0.
+*/
+class BitMatrix {
+    public:
+        using word_t = std::uint64_t;
+        static constexpr std::size_t word_bits = 64;
+        static constexpr std::size_t simd_words = 4;  // row padding, in words (256 bits)
+
+        BitMatrix(): n {0}, row_stride {0}, words {} { }
+
+        explicit BitMatrix(std::size_t n) : BitMatrix() { resize(n); }
+
+
+        /**
+        * @brief number of words needed to store a row of `bits` bits, padded to `simd_words`
+        */
+        static constexpr std::size_t words_for(std::size_t bits) {
+            const std::size_t w = (bits + word_bits - 1) / word_bits;
+            return (w + simd_words - 1) / simd_words * simd_words;
+        }
+
+
+        /**
+        * @brief number of rows (and columns)
+        */
+        std::size_t size() const { return n; }
+
+        /**
+        * @brief number of words per row
+        */
+        std::size_t stride() const { return row_stride; }
+
+        /**
+        * @brief bytes used by the matrix storage
+        */
+        std::size_t bytes() const { return words.capacity() * sizeof(word_t); }
+
+
+        /**
+        * @brief removes all rows, and goes back to the narrowest row layout
+        */
+        void clear();
+
+        /**
+        * @brief preallocates space for an `n` x `n` matrix
+        */
+        void reserve(std::size_t n);
+
+        /**
+        * @brief grows or shrinks the matrix, keeping the existing bits. New rows and columns are 0. Rows keep their
+        * width when shrinking (except to 0, like `clear()`)
+        */
+        void resize(std::size_t n);
+
+        /**
+        * @brief replaces the matrix with `n` rows of `words_for(n)` words each, copied in one block
+        */
+        void assign(std::size_t n, const word_t * rows);
+
+
+        bool test(std::size_t i, std::size_t j) const {
+            return (row(i)[j / word_bits] >> (j % word_bits)) & 1;
+        }
+
+        void set(std::size_t i, std::size_t j) {
+            row(i)[j / word_bits] |= word_t {1} << (j % word_bits);
+        }
+
+        void reset(std::size_t i, std::size_t j) {
+            row(i)[j / word_bits] &= ~(word_t {1} << (j % word_bits));
+        }
+
+
+        word_t * row(std::size_t i) { return words.data() + i * row_stride; }
+
+        const word_t * row(std::size_t i) const { return words.data() + i * row_stride; }
+
+
+        /**
+        * @brief number of bits set in row i
+        */
+        std::size_t count(std::size_t i) const { return count(row(i), row_stride); }
+
+        /**
+        * @brief checks if every bit of `mask` (a row-sized word array) is also set in row i
+        */
+        bool covers(std::size_t i, const word_t * mask) const;
+
+
+        /* neighborhood operations on row-sized word arrays (what CliqueSearch needs of an adjacency, see also SatGraph) */
+
+        /**
+        * @brief out = row i
+        */
+        void copy_row(std::size_t i, word_t * out) const {
+            const word_t * r = row(i);
+            for (std::size_t k = 0; k < row_stride; ++k) out[k] = r[k];
+        }
+
+        /**
+        * @brief out = set ∩ row i
+        */
+        void intersect(std::size_t i, const word_t * set, word_t * out) const {
+            const word_t * r = row(i);
+            for (std::size_t k = 0; k < row_stride; ++k) out[k] = set[k] & r[k];
+        }
+
+        /**
+        * @brief out = set \ row i
+        */
+        void subtract(std::size_t i, const word_t * set, word_t * out) const {
+            const word_t * r = row(i);
+            for (std::size_t k = 0; k < row_stride; ++k) out[k] = set[k] & ~r[k];
+        }
+
+        /**
+        * @brief number of bits of `set` also set in row i
+        */
+        std::size_t count_in(std::size_t i, const word_t * set) const { return count_and(row(i), set, row_stride); }
+
+
+        /* word array helpers */
+
+        /**
+        * @brief number of bits set in a word array
+        */
+        static std::size_t count(const word_t * w, std::size_t n_words);
+
+        /**
+        * @brief number of bits set in the intersection of two word arrays
+        */
+        static std::size_t count_and(const word_t * a, const word_t * b, std::size_t n_words);
+
+
+    private:
+        std::size_t n;  // number of rows/columns
+        std::size_t row_stride;  // words per row
+        std::vector<word_t, AlignedAllocator<word_t>> words;
+
+        /**
+        * @brief moves the rows to a new row stride (in words, multiple of `simd_words`)
+        */
+        void relayout(std::size_t new_stride);
+};
+
+
+
+/**
+ * @brief calls `f(i)` for the index of every bit set in a word array, in increasing order
+*/
+template <typename F>
+inline void for_each_bit(const BitMatrix::word_t * w, std::size_t n_words, F f) {
+    for (std::size_t k = 0; k < n_words; ++k) {
+        BitMatrix::word_t word = w[k];
+        while (word) {
+            f(k * BitMatrix::word_bits + std::countr_zero(word));
+            word &= word - 1;  // clear lowest bit
+        }
+    }
+}
+
+
+
+/**
+ * @brief transposes a 64 x 64 bit tile (bit j of word i <-> bit i of word j), swapping ever smaller
+ * off-diagonal blocks (Hacker's Delight 7-3)
+*/
+inline void transpose(std::array<BitMatrix::word_t, 64> & tile) {
+    BitMatrix::word_t mask = 0x00000000FFFFFFFF;
+    for (unsigned j = 32; j != 0; j >>= 1, mask ^= mask << j) {
+        for (unsigned k = 0; k < 64; k = ((k | j) + 1) & ~j) {
+            const BitMatrix::word_t t = ((tile[k] >> j) ^ tile[k | j]) & mask;
+            tile[k] ^= t << j;
+            tile[k | j] ^= t;
+        }
+    }
+}
+
+
+
+#endif
@@ -0,0 +1,277 @@
+#include "clique.hpp"
+#include "parallel.hpp"
+#include "counters.hpp"
+#include "satgraph.hpp"
+#include "csr.hpp"
+
+#include <algorithm>
+#include <type_traits>
+
+
+
+template <typename Adjacency>
+std::vector<int> degeneracy_order(const Adjacency & adjacency, int * degeneracy) {
+    // Batagelj & Zaversnik: nodes bucket-sorted by degree, moved down a bucket when a neighbor is removed. O(n + m)
+    const std::size_t n = adjacency.size();
+
+    std::vector<int> degree (n);
+    int max_degree = 0;
+    for (std::size_t v = 0; v < n; ++v) {
+        if constexpr (std::is_same_v<Adjacency, CSRGraph>) degree[v] = adjacency.degree(v);
+        else degree[v] = adjacency.count(v);
+        max_degree = std::max(max_degree, degree[v]);
+    }
+
+    std::vector<int> bucket (max_degree + 2, 0);  // start of each degree in `order`
+    for (std::size_t v = 0; v < n; ++v) ++bucket[degree[v] + 1];
+    for (int d = 0; d <= max_degree; ++d) bucket[d + 1] += bucket[d];
+
+    std::vector<int> order (n);
+    std::vector<int> position (n);
+    {
+        std::vector<int> next (bucket.begin(), bucket.end() - 1);
+        for (std::size_t v = 0; v < n; ++v) {
+            position[v] = next[degree[v]]++;
+            order[position[v]] = v;
+        }
+    }
+
+    int d_max = 0;
+    std::vector<bool> removed (n, false);
+    std::vector<BitMatrix::word_t> neighbors {};
+    if constexpr (!std::is_same_v<Adjacency, CSRGraph>) neighbors.resize(adjacency.stride());
+    for (std::size_t i = 0; i < n; ++i) {
+        const int v = order[i];
+        removed[v] = true;
+        d_max = std::max(d_max, degree[v]);
+
+        auto lower = [&](std::size_t u) {
+            if (removed[u] || degree[u] <= degree[v]) return;
+
+            // swap u with the first node of its bucket, then shrink the bucket past it
+            const int first = bucket[degree[u]];
+            const int w = order[first];
+            if (w != static_cast<int>(u)) {
+                std::swap(order[first], order[position[u]]);
+                position[w] = position[u];
+                position[u] = first;
+            }
+            ++bucket[degree[u]];
+            --degree[u];
+        };
+
+        if constexpr (std::is_same_v<Adjacency, CSRGraph>) {
+            for (int u : adjacency.neighbors(v)) lower(u);
+        }
+        else {
+            adjacency.copy_row(v, neighbors.data());
+            for_each_bit(neighbors.data(), neighbors.size(), lower);
+        }
+    }
+
+    if (degeneracy) *degeneracy = d_max;
+    return order;
+}
+
+
+
+template <typename Adjacency>
+CliqueSearch<Adjacency>::CliqueSearch(const Adjacency & adjacency, int target, SharedClique * shared) :
+    adj {adjacency},
+    n_words {adjacency.stride()},
+    target {static_cast<std::size_t>(std::max(target, 0))},
+    shared {shared},
+    current {},
+    best {},
+    levels {}
+{ }
+
+
+template <typename Adjacency>
+std::vector<int> CliqueSearch<Adjacency>::run() {
+    const std::size_t n = adj.size();
+    current.clear();
+    best.clear();
+
+    if (n == 0) return best;
+    best.push_back(0);  // any node is a clique
+    if (done()) return best;
+
+    const std::vector<int> order = degeneracy_order(adj);
+    std::vector<int> position (n);
+    for (std::size_t i = 0; i < n; ++i) position[order[i]] = i;
+
+    // densest part of the graph first (end of the order), so large cliques are found early and prune the rest
+    for (auto v = order.rbegin(); v != order.rend(); ++v) {
+        branch(*v, position);
+        if (done()) break;
+    }
+
+    std::sort(best.begin(), best.end());
+    return best;
+}
+
+
+template <typename Adjacency>
+void CliqueSearch<Adjacency>::branch(int v, const std::vector<int> & position) {
+    if (done()) return;
+    if (levels.empty()) {
+        levels.emplace_back(3 * n_words);
+        P2_COUNT(bytes_allocated, 3 * n_words * sizeof(word_t));
+    }
+
+    // P = later neighbors of v, X = earlier neighbors of v (their cliques were already explored)
+    word_t * P = levels[0].data();
+    word_t * X = P + n_words;
+    word_t * neighbors = X + n_words;  // scratch until expand() uses it
+    std::fill_n(P, 2 * n_words, 0);
+
+    adj.copy_row(v, neighbors);
+    for_each_bit(neighbors, n_words, [&](std::size_t u) {
+        const word_t bit = word_t {1} << (u % BitMatrix::word_bits);
+        if (position[u] > position[v]) P[u / BitMatrix::word_bits] |= bit;
+        else X[u / BitMatrix::word_bits] |= bit;
+    });
+
+    current.assign(1, v);
+    if (best_size() == 0) found();
+    if (1 + BitMatrix::count(P, n_words) <= bound()) {  // can't beat the best clique
+        P2_COUNT(pruned, 1);
+        return;
+    }
+
+    expand(0);
+}
+
+
+template <typename Adjacency>
+void CliqueSearch<Adjacency>::found() {
+    best = current;
+    if (!shared) return;
+
+    std::lock_guard<std::mutex> guard {shared->lock};
+    if (current.size() > shared->nodes.size()) {
+        shared->nodes = current;
+        shared->size.store(current.size(), std::memory_order_relaxed);
+        if (target > 0 && current.size() >= target) shared->stop.store(true, std::memory_order_relaxed);
+    }
+}
+
+
+template <typename Adjacency>
+void CliqueSearch<Adjacency>::expand(std::size_t depth) {
+    if (levels.size() < depth + 2) {
+        levels.emplace_back(3 * n_words);  // moving the vectors keeps their buffers
+        P2_COUNT(bytes_allocated, 3 * n_words * sizeof(word_t));
+    }
+    P2_COUNT(nodes_expanded, 1);
+    P2_DEPTH(current.size());
+
+    word_t * P = levels[depth].data();
+    word_t * X = P + n_words;
+    word_t * branching = X + n_words;
+    word_t * next_P = levels[depth + 1].data();
+    word_t * next_X = next_P + n_words;
+
+    std::size_t candidates = BitMatrix::count(P, n_words);
+    if (candidates == 0) {
+        if (current.size() > bound()) found();
+        return;
+    }
+    if (current.size() + candidates <= bound()) {
+        P2_COUNT(pruned, 1);
+        return;
+    }
+
+    // pivot: node of P ∪ X with the most neighbors in P. Only its non-neighbors need to be branched on
+    std::size_t pivot = 0;
+    std::size_t pivot_degree = 0;
+    bool has_pivot = false;
+    auto try_pivot = [&](std::size_t u) {
+        const std::size_t d = adj.count_in(u, P);
+        if (!has_pivot || d > pivot_degree) {
+            pivot = u;
+            pivot_degree = d;
+            has_pivot = true;
+        }
+    };
+    for_each_bit(P, n_words, try_pivot);
+    for_each_bit(X, n_words, try_pivot);
+
+    // P only loses nodes already branched on, so the branches can be taken upfront
+    adj.subtract(pivot, P, branching);
+
+    for (std::size_t k = 0; k < n_words; ++k) {
+        word_t branch = branching[k];
+
+        while (branch) {
+            const std::size_t v = k * BitMatrix::word_bits + std::countr_zero(branch);
+            const word_t bit = branch & -branch;
+            branch &= branch - 1;
+
+            // recurse on R + v, P ∩ N(v), X ∩ N(v)
+            adj.intersect(v, P, next_P);
+            adj.intersect(v, X, next_X);
+
+            current.push_back(v);
+            expand(depth + 1);
+            current.pop_back();
+            if (done()) return;
+
+            // move v from P to X
+            P[k] &= ~bit;
+            X[k] |= bit;
+            --candidates;
+            if (current.size() + candidates <= bound()) {
+                P2_COUNT(pruned, 1);
+                return;
+            }
+        }
+    }
+}
+
+
+
+template <typename Adjacency>
+std::vector<int> parallel_max_clique(const Adjacency & adjacency, int target, unsigned threads) {
+    const std::size_t n = adjacency.size();
+    if (n == 0) return {};
+
+    const std::vector<int> order = degeneracy_order(adjacency);
+    std::vector<int> position (n);
+    for (std::size_t i = 0; i < n; ++i) position[order[i]] = i;
+
+    SharedClique shared {};
+    TaskPool pool {threads};
+    Counters & caller = counters;  // the workers' counts are added to the calling thread's
+    std::mutex counters_lock;
+
+    // one search (and its buffers) per worker
+    std::vector<CliqueSearch<Adjacency>> searches {};
+    searches.reserve(pool.size());
+    for (unsigned t = 0; t < pool.size(); ++t) searches.emplace_back(adjacency, target, &shared);
+
+    // one task per top-level branch, densest part of the graph first
+    for (auto v = order.rbegin(); v != order.rend(); ++v) {
+        pool.submit([&, v = *v]() {
+            count_for(caller, counters_lock, [&]() { searches[TaskPool::worker_index()].branch(v, position); });
+        });
+    }
+    pool.wait();
+
+    std::vector<int> best = shared.nodes;
+    std::sort(best.begin(), best.end());
+    return best;
+}
+
+
+
+template std::vector<int> degeneracy_order(const BitMatrix &, int *);
+template std::vector<int> degeneracy_order(const SatGraph &, int *);
+template std::vector<int> degeneracy_order(const CSRGraph &, int *);
+
+template class CliqueSearch<BitMatrix>;
+template class CliqueSearch<SatGraph>;
+
+template std::vector<int> parallel_max_clique(const BitMatrix &, int, unsigned);
+template std::vector<int> parallel_max_clique(const SatGraph &, int, unsigned);
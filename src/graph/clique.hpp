@@ -0,0 +1,126 @@
+#ifndef CLIQUE_HPP
+#define CLIQUE_HPP
+
+
+#include <vector>
+#include <cstddef>
+#include <atomic>
+#include <mutex>
+#include <algorithm>
+
+#include "bitmatrix.hpp"
+
+
+
+/**
+ * @brief orders the nodes by repeatedly removing one of minimum degree (smallest-last order).
+ * Every node has at most `degeneracy` neighbors later in the order
+ * @param adjacency BitMatrix, SatGraph or CSRGraph
+ * @return order and degeneracy
+*/
+template <typename Adjacency>
+std::vector<int> degeneracy_order(const Adjacency & adjacency, int * degeneracy = nullptr);
+
+
+
+/**
+ * @brief best clique found by a group of searches running in parallel
+*/
+struct SharedClique {
+    std::atomic<std::size_t> size {0};  // read without locking, as the bound of every search
+    std::atomic<bool> stop {false};  // set when the target was reached
+    std::mutex lock;  // protects nodes
+    std::vector<int> nodes {};
+};
+
+
+
+/**
+ * @brief maximum clique search using Bron–Kerbosch with Tomita pivoting
+ *
+ * The top level goes through the nodes in degeneracy order, so each branch starts with at most
+ * `degeneracy` candidates. Candidate (P) and excluded (X) sets are bitsets, so intersections with
+ * a neighborhood and the pivot choice are AND + popcount over words. Branches that can't beat the
+ * best clique found so far are pruned.
+ *
+ * The adjacency is only used through the neighborhood operations of BitMatrix (copy_row, intersect,
+ * subtract, count_in), so it can also be an implicit graph such as SatGraph. Both are instantiated in clique.cpp.
+*/
+template <typename Adjacency = BitMatrix>
+class CliqueSearch {
+    public:
+        using word_t = BitMatrix::word_t;
+
+        /**
+        * @param target stop as soon as a clique of `target` nodes is found (0 = find a maximum clique)
+        * @param shared if set, the best clique is shared with (and bounded by) other searches
+        */
+        CliqueSearch(const Adjacency & adjacency, int target = 0, SharedClique * shared = nullptr);
+
+        /**
+        * @brief runs the whole search
+        * @return nodes of the clique, sorted. With a target, it has fewer nodes (and isn't necessarily maximum) if there is no clique of `target` nodes
+        */
+        std::vector<int> run();
+
+        /**
+        * @brief explores the cliques whose first node in the order given by `position` is v
+        */
+        void branch(int v, const std::vector<int> & position);
+
+        /**
+        * @brief checks if the target was reached (by this search or any other sharing the best clique)
+        */
+        bool done() const {
+            if (shared) return shared->stop.load(std::memory_order_relaxed);
+            return target > 0 && best.size() >= target;
+        }
+
+
+    private:
+        const Adjacency & adj;
+        const std::size_t n_words;
+        const std::size_t target;
+        SharedClique * shared;
+
+        std::vector<int> current;  // R
+        std::vector<int> best;
+
+        std::vector<std::vector<word_t>> levels;  // P, X & the nodes to branch on of every depth, 3 * n_words each
+
+        std::size_t best_size() const {
+            return shared ? shared->size.load(std::memory_order_relaxed) : best.size();
+        }
+
+        /**
+        * @brief size a clique must exceed to be worth exploring. With a target, smaller cliques don't matter
+        */
+        std::size_t bound() const {
+            return std::max(best_size(), target > 0 ? target - 1 : 0);
+        }
+
+        /**
+        * @brief records the current clique as the best one
+        */
+        void found();
+
+        /**
+        * @brief extends the current clique with the candidates in P (P & X of depth `depth` in `levels`)
+        */
+        void expand(std::size_t depth);
+};
+
+
+
+/**
+ * @brief maximum clique search with the top-level branches of CliqueSearch spread over `threads` threads
+ * (0 = one per core) with work stealing. Searches share the size of the best clique found as their bound,
+ * and all stop as soon as one finds a clique of `target` nodes
+ * @return nodes of the clique, sorted. With a target, it has fewer nodes (and isn't necessarily maximum) if there is no clique of `target` nodes
+*/
+template <typename Adjacency>
+std::vector<int> parallel_max_clique(const Adjacency & adjacency, int target = 0, unsigned threads = 0);
+
+
+
+#endif
@@ -0,0 +1,60 @@
+#include "closure.hpp"
+#include "parallel.hpp"
+#include "counters.hpp"
+
+#include <barrier>
+#include <thread>
+#include <vector>
+#include <algorithm>
+
+
+
+/**
+ * @brief row |= other, over the whole (padded) row
+*/
+static inline void or_row(BitMatrix::word_t * __restrict row, const BitMatrix::word_t * __restrict other, std::size_t n_words) {
+    for (std::size_t w = 0; w < n_words; ++w) row[w] |= other[w];
+}
+
+
+
+TransitiveClosure::TransitiveClosure(BitMatrix adjacency, unsigned threads) : closure {std::move(adjacency)} {
+    const std::size_t n = closure.size();
+    const std::size_t n_words = closure.stride();
+
+    for (std::size_t i = 0; i < n; ++i) closure.set(i, i);  // paths of length 0
+
+    P2_COUNT(bytes_allocated, closure.bytes());
+    P2_COUNT(nodes_expanded, n);  // pivots (the rows may be merged by other threads)
+
+    // rows [first, last) through every k. Row k isn't changed by round k, so rows only need to sync between rounds
+    auto rows = [&](std::size_t first, std::size_t last, std::size_t k) {
+        const BitMatrix::word_t * row_k = closure.row(k);
+        for (std::size_t i = first; i < last; ++i) {
+            if (i != k && closure.test(i, k)) or_row(closure.row(i), row_k, n_words);
+        }
+    };
+
+    // a thread per 64 rows at most, otherwise syncing costs more than it saves
+    if (threads == 0) threads = default_threads();
+    threads = static_cast<unsigned>(std::max<std::size_t>(1, std::min<std::size_t>(threads, n / 64)));
+
+    if (threads == 1) {
+        for (std::size_t k = 0; k < n; ++k) rows(0, n, k);
+        return;
+    }
+
+    std::barrier sync (threads);
+    auto worker = [&](unsigned t) {
+        const std::size_t first = n * t / threads;
+        const std::size_t last = n * (t + 1) / threads;
+        for (std::size_t k = 0; k < n; ++k) {
+            rows(first, last, k);
+            sync.arrive_and_wait();
+        }
+    };
+
+    std::vector<std::jthread> pool {};
+    for (unsigned t = 1; t < threads; ++t) pool.emplace_back(worker, t);
+    worker(0);
+}
@@ -0,0 +1,50 @@
+#ifndef CLOSURE_HPP
+#define CLOSURE_HPP
+
+
+#include <cstddef>
+
+#include "bitmatrix.hpp"
+
+
+
+/**
+ * @brief reachability index: bit (u, v) is set if there is a path from u to v (every node reaches itself)
+ *
+ * Built with Warshall's algorithm on bitset rows: for every k, each row that reaches k gets `row |= row_k`,
+ * 64 nodes per word and a whole SIMD register per instruction. Rows are split across threads.
+ * Cost: O(n^3 / 64) time and n^2 bits of memory
+*/
+class TransitiveClosure {
+    public:
+        TransitiveClosure(): closure {} { }
+
+        /**
+        * @brief computes the closure of an adjacency matrix, using `threads` threads (0 = one per core)
+        */
+        explicit TransitiveClosure(BitMatrix adjacency, unsigned threads = 1);
+
+
+        /**
+        * @brief number of nodes
+        */
+        std::size_t size() const { return closure.size(); }
+
+        /**
+        * @brief checks if there is a path from u to v
+        */
+        bool reachable(std::size_t u, std::size_t v) const { return closure.test(u, v); }
+
+        /**
+        * @brief the closure as a bit matrix
+        */
+        const BitMatrix & matrix() const { return closure; }
+
+
+    private:
+        BitMatrix closure;
+};
+
+
+
+#endif
@@ -0,0 +1,47 @@
+#include "components.hpp"
+
+#include <utility>
+
+
+
+void DisjointSets::clear() {
+    parent.clear();
+    rank.clear();
+    sets = 0;
+}
+
+
+int DisjointSets::add() {
+    const int x = static_cast<int>(parent.size());
+    parent.push_back(x);
+    rank.push_back(0);
+    ++sets;
+
+    return x;
+}
+
+
+int DisjointSets::find(int x) {
+    // path halving: point every other node of the path to its grandparent
+    while (parent[x] != x) {
+        parent[x] = parent[parent[x]];
+        x = parent[x];
+    }
+
+    return x;
+}
+
+
+bool DisjointSets::unite(int a, int b) {
+    a = find(a);
+    b = find(b);
+    if (a == b) return false;
+
+    // hang the shorter tree from the taller one
+    if (rank[a] < rank[b]) std::swap(a, b);
+    parent[b] = a;
+    if (rank[a] == rank[b]) ++rank[a];
+    --sets;
+
+    return true;
+}
@@ -0,0 +1,68 @@
+#ifndef COMPONENTS_HPP
+#define COMPONENTS_HPP
+
+
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+
+
+/**
+ * @brief union-find over the nodes of a graph, with path compression and union by rank.
+ * Any sequence of m operations on n nodes costs O(m α(n)), i.e. O(1) in practice
+*/
+class DisjointSets {
+    public:
+        DisjointSets(): parent {}, rank {}, sets {0} { }
+
+        explicit DisjointSets(std::size_t n) : DisjointSets() {
+            for (std::size_t i = 0; i < n; ++i) add();
+        }
+
+
+        /**
+        * @brief number of elements
+        */
+        std::size_t size() const { return parent.size(); }
+
+        /**
+        * @brief number of disjoint sets
+        */
+        std::size_t count() const { return sets; }
+
+        /**
+        * @brief removes all elements
+        */
+        void clear();
+
+        /**
+        * @brief adds a new element in its own set, and returns it
+        */
+        int add();
+
+        /**
+        * @brief returns the representative of the set of x
+        */
+        int find(int x);
+
+        /**
+        * @brief merges the sets of a & b. Returns false if they already were the same set
+        */
+        bool unite(int a, int b);
+
+        /**
+        * @brief checks if a & b are in the same set
+        */
+        bool same(int a, int b) { return find(a) == find(b); }
+
+
+    private:
+        std::vector<int> parent;
+        std::vector<std::uint8_t> rank;  // upper bound of the height of each tree (< 64)
+        std::size_t sets;
+};
+
+
+
+#endif
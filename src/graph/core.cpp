@@ -0,0 +1,100 @@
+#include "core.hpp"
+#include "counters.hpp"
+
+#include <algorithm>
+#include <utility>
+#include <numeric>
+
+
+
+/**
+ * @brief peels the nodes with fewer than k neighbors, given every degree and a way to visit the neighbors of a node
+*/
+template <typename Neighbors>
+static std::vector<int> peel(std::vector<int> degree, int k, Neighbors for_each_neighbor) {
+    const std::size_t n = degree.size();
+
+    std::vector<bool> removed (n, false);
+    std::vector<int> stack {};
+    for (std::size_t v = 0; v < n; ++v) {
+        if (degree[v] < k) {
+            removed[v] = true;
+            stack.push_back(v);
+        }
+    }
+
+    // a (non-empty) k-core has at least k + 1 nodes, all of them among the ones left
+    if (n - stack.size() <= static_cast<std::size_t>(std::max(k, 0))) return {};
+
+    // every node is removed once, and each removal visits its neighbors once
+    while (!stack.empty()) {
+        const int v = stack.back();
+        stack.pop_back();
+
+        for_each_neighbor(v, [&](std::size_t u) {
+            P2_COUNT(edges_scanned, 1);
+            if (removed[u] || --degree[u] >= k) return;
+            removed[u] = true;
+            stack.push_back(u);
+        });
+    }
+
+    std::vector<int> core {};
+    for (std::size_t v = 0; v < n; ++v) {
+        if (!removed[v]) core.push_back(v);
+    }
+
+    return core;
+}
+
+
+
+std::vector<int> k_core(const BitMatrix & adjacency, int k) {
+    std::vector<int> degree (adjacency.size());
+    for (std::size_t v = 0; v < adjacency.size(); ++v) degree[v] = adjacency.count(v);
+    P2_COUNT(edges_scanned, std::accumulate(degree.begin(), degree.end(), std::size_t {0}));
+
+    return peel(std::move(degree), k, [&](int v, auto f) { for_each_bit(adjacency.row(v), adjacency.stride(), f); });
+}
+
+
+std::vector<int> k_core(const CSRGraph & graph, int k) {
+    std::vector<int> degree (graph.size());
+    for (std::size_t v = 0; v < graph.size(); ++v) degree[v] = graph.degree(v);
+
+    return peel(std::move(degree), k, [&](int v, auto f) {
+        for (auto & u : graph.neighbors(v)) f(u);
+    });
+}
+
+
+
+BitMatrix induced_subgraph(const BitMatrix & adjacency, const std::vector<int> & nodes) {
+    std::vector<int> label (adjacency.size(), -1);  // new label of every kept node
+    for (std::size_t i = 0; i < nodes.size(); ++i) label[nodes[i]] = i;
+
+    BitMatrix subgraph (nodes.size());
+    for (std::size_t i = 0; i < nodes.size(); ++i) {
+        for_each_bit(adjacency.row(nodes[i]), adjacency.stride(), [&](std::size_t u) {
+            if (label[u] >= 0) subgraph.set(i, label[u]);
+        });
+    }
+
+    return subgraph;
+}
+
+
+CSRGraph induced_subgraph(const CSRGraph & graph, const std::vector<int> & nodes) {
+    std::vector<int> label (graph.size(), -1);
+    for (std::size_t i = 0; i < nodes.size(); ++i) label[nodes[i]] = i;
+
+    // every edge once (u < v). Relabeling keeps the order, so the list stays sorted
+    std::vector<std::pair<int, int>> edge_list {};
+    for (std::size_t i = 0; i < nodes.size(); ++i) {
+        for (auto & u : graph.neighbors(nodes[i])) {
+            if (u > nodes[i] && label[u] >= 0) edge_list.emplace_back(i, label[u]);
+        }
+    }
+
+    return CSRGraph(nodes.size(), edge_list);
+}
@@ -0,0 +1,33 @@
+#ifndef CORE_HPP
+#define CORE_HPP
+
+
+#include <vector>
+#include <cstddef>
+
+#include "bitmatrix.hpp"
+#include "csr.hpp"
+
+
+
+/**
+ * @brief nodes of the k-core: what's left after repeatedly removing the nodes with fewer than k neighbors.
+ * A clique of k + 1 nodes can only use nodes of the k-core. Degrees are computed once and updated as nodes
+ * are peeled, so it takes O(n + m)
+ * @return nodes of the core, sorted
+*/
+std::vector<int> k_core(const BitMatrix & adjacency, int k);
+
+std::vector<int> k_core(const CSRGraph & graph, int k);
+
+
+/**
+ * @brief subgraph induced by `nodes` (sorted), relabeled so that nodes[i] becomes i
+*/
+BitMatrix induced_subgraph(const BitMatrix & adjacency, const std::vector<int> & nodes);
+
+CSRGraph induced_subgraph(const CSRGraph & graph, const std::vector<int> & nodes);
+
+
+
+#endif
@@ -0,0 +1,103 @@
+#ifndef COUNTERS_HPP
+#define COUNTERS_HPP
+
+
+#include <cstdint>
+#include <algorithm>
+#include <mutex>
+#include <ostream>
+
+
+
+/**
+ * @brief operations counted by the algorithms, to compare against their complexity
+ *
+ * Only built with the P2_COUNTERS option. Otherwise the counting macros expand to nothing (their
+ * arguments aren't even evaluated), so the algorithms cost the same as without counters.
+*/
+struct Counters {
+    std::uint64_t nodes_expanded = 0;  // search nodes / traversed nodes / Floyd-Warshall & closure pivots
+    std::uint64_t edges_scanned = 0;  // neighbors looked at / Floyd-Warshall relaxations
+    std::uint64_t pruned = 0;  // branches cut by a bound
+    std::uint64_t max_depth = 0;  // deepest recursion (clique size, for clique searches)
+    std::uint64_t bytes_allocated = 0;  // by the algorithm's own buffers and results
+
+    Counters & operator += (const Counters & other) {
+        nodes_expanded += other.nodes_expanded;
+        edges_scanned += other.edges_scanned;
+        pruned += other.pruned;
+        max_depth = std::max(max_depth, other.max_depth);
+        bytes_allocated += other.bytes_allocated;
+        return *this;
+    }
+
+    /**
+    * @brief writes the counters as a JSON object, to anything with << for text and numbers (std::ostream, Writer)
+    */
+    template <typename Out>
+    void write_json(Out & out) const {
+        out << "{";
+        out << "\"nodes_expanded\":" << nodes_expanded << ",";
+        out << "\"edges_scanned\":" << edges_scanned << ",";
+        out << "\"pruned\":" << pruned << ",";
+        out << "\"max_depth\":" << max_depth << ",";
+        out << "\"bytes_allocated\":" << bytes_allocated;
+        out << "}";
+    }
+
+    /* JSON object */
+    friend std::ostream & operator << (std::ostream & out, const Counters & c) {
+        c.write_json(out);
+        return out;
+    }
+};
+
+
+/**
+ * @brief counts of the calling thread (reset them before the code to measure)
+*/
+inline thread_local Counters counters {};
+
+
+#if defined(P2_COUNTERS)
+
+constexpr bool counters_enabled = true;
+
+#define P2_COUNT(counter, amount) (counters.counter += (amount))
+#define P2_DEPTH(depth) (counters.max_depth = std::max<std::uint64_t>(counters.max_depth, (depth)))
+
+#else
+
+constexpr bool counters_enabled = false;
+
+#define P2_COUNT(counter, amount) ((void) 0)
+#define P2_DEPTH(depth) ((void) 0)
+
+#endif
+
+
+/**
+ * @brief runs f, and adds what it counted to `total` too. For work that a pool thread does for another thread
+ * (`total` being that thread's counters)
+*/
+template <typename F>
+inline void count_for([[maybe_unused]] Counters & total, [[maybe_unused]] std::mutex & lock, F f) {
+    if constexpr (counters_enabled) {
+        if (&total == &counters) return f();  // already counted there
+
+        const Counters before = counters;
+        counters = {};
+        f();
+
+        {
+            std::lock_guard<std::mutex> guard {lock};
+            total += counters;
+        }
+        counters += before;
+    }
+    else f();
+}
+
+
+
+#endif
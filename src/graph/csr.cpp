@@ -0,0 +1,238 @@
+#include "csr.hpp"
+#include "traversal.hpp"
+#include "core.hpp"
+#include "kclist.hpp"
+#include "counters.hpp"
+
+#include <algorithm>
+
+
+
+CSRGraph::CSRGraph(size_t n, const std::vector<std::pair<int, int>> & edge_list) :
+    offsets(n + 1, 0),
+    targets(2 * edge_list.size()),
+    components(n),
+    distance_cache {},
+    distances_valid {false},
+    closure_cache {},
+    closure_valid {false}
+{
+    // count degrees
+    for (auto & [u, v] : edge_list) {
+        assert(static_cast<size_t>(u) < n && static_cast<size_t>(v) < n);
+        ++offsets[u + 1];
+        ++offsets[v + 1];
+    }
+
+    for (size_t u = 0; u < n; ++u) offsets[u + 1] += offsets[u];
+
+    // scatter both directions of every edge
+    std::vector<size_t> next (offsets.begin(), offsets.end() - 1);
+    for (auto & [u, v] : edge_list) {
+        targets[next[u]++] = v;
+        targets[next[v]++] = u;
+        components.unite(u, v);
+    }
+
+    // sort adjacency lists (already sorted if the edge list is)
+    for (size_t u = 0; u < n; ++u) {
+        auto first = targets.begin() + offsets[u];
+        auto last = targets.begin() + offsets[u + 1];
+        if (!std::is_sorted(first, last)) std::sort(first, last);
+    }
+}
+
+
+CSRGraph::CSRGraph(const GraphFile & file) : CSRGraph() {
+    const size_t n = file.size();
+
+    if (file.format() == GraphFile::Format::csr) {
+        auto file_offsets = file.offsets();
+        auto file_targets = file.targets();
+        offsets.assign(file_offsets.begin(), file_offsets.end());
+        targets.assign(file_targets.begin(), file_targets.end());
+    }
+    else {
+        // the rows are in order, so the lists come out sorted
+        offsets.assign(n + 1, 0);
+        targets.reserve(file.edge_count());
+        for (size_t u = 0; u < n; ++u) {
+            for_each_bit(file.row(u), file.stride(), [&](size_t v) { targets.push_back(v); });
+            offsets[u + 1] = targets.size();
+        }
+    }
+
+    components = DisjointSets(n);
+    for (size_t u = 0; u < n; ++u) {
+        for (int v : neighbors(u)) {
+            if (static_cast<int>(u) < v) components.unite(u, v);
+        }
+    }
+}
+
+
+bool CSRGraph::has_edge(int u, int v) const {
+    auto adj = neighbors(u);
+    return std::binary_search(adj.begin(), adj.end(), v);
+}
+
+
+
+
+/* PATH(u,v) */
+
+
+// scratch space for the PATH traversals, reused by every query of the thread
+static thread_local Traversal traversal {};
+static thread_local MultiSourceBFS<> batch_traversal {};
+
+
+bool CSRGraph::path_dfs(int u, int v) const {
+    assert(u < static_cast<int>(size()));
+    assert(v < static_cast<int>(size()));
+
+    return traversal.dfs(*this, u, v);
+}
+
+
+bool CSRGraph::path_bfs(int u, int v) const {
+    assert(u < static_cast<int>(size()));
+    assert(v < static_cast<int>(size()));
+
+    return traversal.bfs(*this, u, v);
+}
+
+
+std::vector<bool> CSRGraph::path_many(std::span<const std::pair<int, int>> queries) const {
+    return batch_traversal.path_many(*this, queries);
+}
+
+
+ReachableSets CSRGraph::reachable_from(std::span<const int> sources) const {
+    return batch_traversal.reachable_from(*this, sources);
+}
+
+
+bool CSRGraph::path_fw(int u, int v, unsigned threads) const {
+    assert(u < static_cast<int>(size()));
+    assert(v < static_cast<int>(size()));
+
+    if (u == v) return true;
+
+    return distances(threads).reachable(u, v);
+}
+
+
+const DistanceMatrix & CSRGraph::distances(unsigned threads) const {
+    if (distances_valid) return distance_cache;
+
+    // initialize distances (1 per edge)
+    distance_cache = DistanceMatrix(size());
+    for (size_t u = 0; u < size(); ++u) {
+        for (auto & v : neighbors(u)) distance_cache.at(u, v) = 1;
+    }
+
+    floyd_warshall(distance_cache, threads);
+    distances_valid = true;
+
+    return distance_cache;
+}
+
+
+bool CSRGraph::path_uf(int u, int v) const {
+    assert(u < static_cast<int>(size()));
+    assert(v < static_cast<int>(size()));
+
+    return components.same(u, v);
+}
+
+
+bool CSRGraph::path_tc(int u, int v, unsigned threads) const {
+    assert(u < static_cast<int>(size()));
+    assert(v < static_cast<int>(size()));
+
+    return closure(threads).reachable(u, v);
+}
+
+
+const TransitiveClosure & CSRGraph::closure(unsigned threads) const {
+    if (closure_valid) return closure_cache;
+
+    BitMatrix adjacency (size());
+    for (size_t u = 0; u < size(); ++u) {
+        for (auto & v : neighbors(u)) adjacency.set(u, v);
+    }
+
+    closure_cache = TransitiveClosure(std::move(adjacency), threads);
+    closure_valid = true;
+
+    return closure_cache;
+}
+
+
+
+
+/* K_CLIQUE(k) */
+
+
+bool CSRGraph::k_clique(int k) const {
+    if (k <= 1) return k <= static_cast<int>(size());
+
+    // only the nodes of the (k - 1)-core can be in the clique: search on that subgraph, often empty when sparse
+    const std::vector<int> core = k_core(*this, k - 1);
+    if (static_cast<int>(core.size()) < k) return false;
+
+    const CSRGraph subgraph = induced_subgraph(*this, core);
+
+    // every node is a candidate to start a clique
+    std::vector<int> candidates (subgraph.size());
+    for (size_t u = 0; u < subgraph.size(); ++u) candidates[u] = u;
+
+    return subgraph._k_clique(candidates, 0, k);
+}
+
+
+bool CSRGraph::_k_clique(const std::vector<int> & candidates, int depth, int k) const {
+    P2_COUNT(nodes_expanded, 1);
+    P2_DEPTH(depth);
+    std::vector<int> next {};
+
+    for (size_t i = 0; i < candidates.size(); ++i) {
+        const int u = candidates[i];
+        if (depth + static_cast<int>(candidates.size() - i) < k) {  // not enough candidates left
+            P2_COUNT(pruned, 1);
+            return false;
+        }
+        if (degree(u) < k - 1) {
+            P2_COUNT(pruned, 1);
+            continue;
+        }
+
+        if (depth + 1 == k) return true;
+
+        // keep the following candidates adjacent to u (both lists are sorted)
+        auto adj = neighbors(u);
+        P2_COUNT(edges_scanned, adj.size());
+        next.clear();
+        std::set_intersection(
+            candidates.begin() + i + 1, candidates.end(),
+            adj.begin(), adj.end(),
+            std::back_inserter(next)
+        );
+
+        if (depth + 1 + static_cast<int>(next.size()) < k) P2_COUNT(pruned, 1);
+        else if (_k_clique(next, depth + 1, k)) return true;
+    }
+
+    return false;
+}
+
+
+std::uint64_t CSRGraph::count_cliques(int k, unsigned threads) const {
+    return ::count_cliques(*this, k, threads);
+}
+
+
+std::uint64_t CSRGraph::list_cliques(int k, const clique_visitor_t & visit, unsigned threads) const {
+    return ::list_cliques(*this, k, visit, threads);
+}
@@ -0,0 +1,185 @@
+#ifndef CSR_HPP
+#define CSR_HPP
+
+
+#include <vector>
+#include <cassert>
+#include <ostream>
+#include <span>
+#include <utility>
+#include <cstddef>
+#include <string>
+#include <functional>
+#include <cstdint>
+
+#include "apsp.hpp"
+#include "closure.hpp"
+#include "msbfs.hpp"
+#include "components.hpp"
+#include "graphfile.hpp"
+
+
+
+/**
+ * @brief graph stored in Compressed Sparse Row format: the sorted neighbors of node u are
+ * `targets[offsets[u] .. offsets[u + 1])`. Memory and traversals scale with the number of edges.
+*/
+class CSRGraph {
+    public:
+        CSRGraph(): offsets {0}, targets {}, components {}, distance_cache {}, distances_valid {false}, closure_cache {}, closure_valid {false} { }
+
+        /**
+        * @brief builds an undirected graph with n nodes from a list of edges (each pair is added in both directions)
+        */
+        CSRGraph(size_t n, const std::vector<std::pair<int, int>> & edge_list);
+
+        /**
+        * @brief loads a graph file (the adjacency lists are copied from the mapping as they are, a matrix is converted)
+        */
+        explicit CSRGraph(const GraphFile & file);
+
+        /**
+        * @brief writes the graph to a binary file, as adjacency lists (see GraphFile)
+        * @throws std::runtime_error if the file can't be written
+        */
+        void save(const std::string & path) const { GraphFile::save(path, offsets, targets); }
+
+
+        /**
+        * @brief returns the number of nodes
+        */
+        size_t size() const { return offsets.size() - 1; }
+
+        /**
+        * @brief returns the number of (directed) edges
+        */
+        size_t edge_count() const { return targets.size(); }
+
+        /**
+        * @brief returns the sorted list of nodes adjacent to u
+        */
+        std::span<const int> neighbors(int u) const {
+            return {targets.data() + offsets[u], targets.data() + offsets[u + 1]};
+        }
+
+        /**
+        * @brief computes the degree of a node
+        */
+        int degree(int u) const { return static_cast<int>(offsets[u + 1] - offsets[u]); }
+
+        /**
+        * @brief checks if there is an edge from u to v
+        */
+        bool has_edge(int u, int v) const;
+
+
+        /* overload << operator (adjacency lists) */
+        friend std::ostream & operator << (std::ostream & out, const CSRGraph & graph) {
+            out << "[";
+            for (size_t u = 0; u < graph.size(); ++u) {
+                out << "[";
+                auto adj = graph.neighbors(u);
+                for (size_t i = 0; i < adj.size(); ++i) {
+                    out << adj[i];
+                    if (i < adj.size() - 1) out << ", ";  // not last element
+                }
+                out << "]";
+
+                if (u < graph.size() - 1) out << ", ";  // not last element
+            }
+            out << "]";
+
+            return out;
+        }
+
+
+        /* PATH implementations */
+
+        /**
+        * @brief PATH(u, v) using Depth First Search
+        */
+        bool path_dfs(int u, int v) const;
+
+        /**
+        * @brief PATH(u, v) using direction-optimizing Breadth First Search
+        */
+        bool path_bfs(int u, int v) const;
+
+        /**
+        * @brief PATH(u, v) using Floyd-Warshall. Needs an n x n matrix, so it's only meant for small graphs
+        */
+        bool path_fw(int u, int v, unsigned threads = 1) const;
+
+        /**
+        * @brief shortest path lengths between all pairs of nodes (computed on the first call, on `threads` threads)
+        */
+        const DistanceMatrix & distances(unsigned threads = 1) const;
+
+        /**
+        * @brief PATH(u, v) using the connected components, computed when the graph is built. Near O(1)
+        */
+        bool path_uf(int u, int v) const;
+
+        /**
+        * @brief PATH(u, v) using the transitive closure. Needs n^2 bits, so it's only meant for mid-sized graphs
+        */
+        bool path_tc(int u, int v, unsigned threads = 1) const;
+
+        /**
+        * @brief reachability between all pairs of nodes (computed on the first call, on `threads` threads)
+        */
+        const TransitiveClosure & closure(unsigned threads = 1) const;
+
+
+        /**
+        * @brief PATH(u, v) for every pair of a batch, using multi-source BFS: the traversals of up to 256 sources
+        * advance together, sharing every adjacency scan (see MultiSourceBFS)
+        */
+        std::vector<bool> path_many(std::span<const std::pair<int, int>> queries) const;
+
+        /**
+        * @brief nodes reachable from each of `sources` (row i for sources[i]), using multi-source BFS
+        */
+        ReachableSets reachable_from(std::span<const int> sources) const;
+
+
+        /* K-CLIQUE implementations */
+
+        /**
+         * @brief checks if there is a complete subgraph of size k
+        */
+        bool k_clique(int k) const;
+
+        /**
+         * @brief number of complete subgraphs of size k (kClist, see count_cliques), on `threads` threads (0 = one per core)
+        */
+        std::uint64_t count_cliques(int k, unsigned threads = 1) const;
+
+        /**
+         * @brief passes every complete subgraph of size k (sorted) to `visit` as it's found (see list_cliques)
+         * @return number of cliques
+        */
+        std::uint64_t list_cliques(int k, const std::function<void(std::span<const int>)> & visit, unsigned threads = 1) const;
+
+
+    protected:
+        std::vector<size_t> offsets;  // size() + 1 entries
+        std::vector<int> targets;  // concatenated adjacency lists
+
+        mutable DisjointSets components;  // connected components (finds compress paths, hence mutable)
+
+        mutable DistanceMatrix distance_cache;  // all-pairs distances, see distances()
+        mutable bool distances_valid;
+
+        mutable TransitiveClosure closure_cache;  // see closure()
+        mutable bool closure_valid;
+
+        /**
+         * @brief extends a clique of size `depth` with the nodes in `candidates` (all adjacent to the clique)
+        */
+        bool _k_clique(const std::vector<int> & candidates, int depth, int k) const;
+};
+
+
+
+#endif
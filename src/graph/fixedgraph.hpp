@@ -0,0 +1,209 @@
+#ifndef FIXEDGRAPH_HPP
+#define FIXEDGRAPH_HPP
+
+
+#include <array>
+#include <vector>
+#include <span>
+#include <string>
+#include <stdexcept>
+#include <utility>
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cassert>
+
+#include "bitmatrix.hpp"
+#include "counters.hpp"
+
+
+
+/**
+ * @brief graph of at most N nodes (a multiple of 64), with its size known at compile time
+ *
+ * Every row is a `std::array` of N / 64 words, and the set operations are unrolled over them at compile time,
+ * so a set of nodes fits in one or a few registers, is passed by value and never allocates. The whole
+ * matrix (N^2 bits, 8 KiB for 256 nodes) stays in L1. See `with_fixed_graph` to pick N at runtime.
+*/
+template <std::size_t N>
+class FixedGraph {
+    static_assert(N > 0 && N % BitMatrix::word_bits == 0, "N must be a multiple of 64");
+
+    public:
+        using word_t = BitMatrix::word_t;
+
+        static constexpr std::size_t words = N / BitMatrix::word_bits;
+
+        using set_t = std::array<word_t, words>;  // bit set of nodes
+
+        FixedGraph(): n {0}, rows {} { }
+
+        /**
+        * @brief copies a graph of at most N nodes
+        * @param adjacency BitMatrix or SatGraph (anything with `size()`, `stride()` and `copy_row()`)
+        * @throws std::invalid_argument if it has more than N nodes
+        */
+        template <typename Adjacency>
+        explicit FixedGraph(const Adjacency & adjacency) : n {adjacency.size()}, rows {} {
+            if (n > N) throw std::invalid_argument("a graph of " + std::to_string(n) + " nodes doesn't fit in FixedGraph<" + std::to_string(N) + ">");
+
+            // rows can be any width (a BitMatrix keeps its widest one), only the first words have nodes
+            std::vector<word_t> row (adjacency.stride());
+            for (std::size_t i = 0; i < n; ++i) {
+                adjacency.copy_row(i, row.data());
+                std::copy_n(row.data(), std::min(row.size(), words), rows[i].data());
+            }
+        }
+
+
+        /**
+        * @brief returns the number of nodes
+        */
+        std::size_t size() const { return n; }
+
+        bool has_edge(int u, int v) const { return contains(rows[u], v); }
+
+        const set_t & neighbors(int u) const { return rows[u]; }
+
+
+        /**
+        * @brief PATH(u, v) using a BFS on sets: every level is the union of the rows of the previous one
+        */
+        bool path(int u, int v) const {
+            assert(static_cast<std::size_t>(u) < n && static_cast<std::size_t>(v) < n);
+            if (u == v) return true;
+
+            set_t seen = single(u);
+            set_t frontier = seen;
+            while (!empty(frontier)) {
+                set_t next {};
+                for_each_bit(frontier.data(), words, [&](std::size_t w) {
+                    P2_COUNT(nodes_expanded, 1);
+                    next = either(next, rows[w]);
+                });
+                next = without(next, seen);
+
+                if (contains(next, v)) return true;
+                seen = either(seen, next);
+                frontier = next;
+            }
+            return false;
+        }
+
+        /**
+        * @brief checks if every pair of nodes of the list is connected
+        */
+        bool is_clique(std::span<const int> nodes) const {
+            set_t mask {};
+            for (int v : nodes) mask = either(mask, single(v));
+
+            for (int v : nodes) {
+                P2_COUNT(edges_scanned, nodes.size());
+                if (count(both(rows[v], mask)) + 1 != nodes.size()) return false;
+            }
+            return true;
+        }
+
+        /**
+        * @brief checks if there is a complete subgraph of size k, using backtracking (as Graph::k_clique_bt) on
+        * sets of candidates: every node added keeps the candidates that are its neighbors
+        */
+        bool k_clique(int k) const {
+            if (k <= 0) return true;
+            if (static_cast<std::size_t>(k) > n) return false;
+
+            set_t all {};
+            for (std::size_t v = 0; v < n; ++v) all = either(all, single(v));
+            return extend(all, 0, k);
+        }
+
+
+        /* set operations, unrolled over the words */
+
+        static constexpr set_t both(const set_t & a, const set_t & b) {
+            return unrolled([&]<std::size_t... I>(std::index_sequence<I...>) { return set_t {(a[I] & b[I])...}; });
+        }
+
+        static constexpr set_t either(const set_t & a, const set_t & b) {
+            return unrolled([&]<std::size_t... I>(std::index_sequence<I...>) { return set_t {(a[I] | b[I])...}; });
+        }
+
+        static constexpr set_t without(const set_t & a, const set_t & b) {
+            return unrolled([&]<std::size_t... I>(std::index_sequence<I...>) { return set_t {(a[I] & ~b[I])...}; });
+        }
+
+        static constexpr std::size_t count(const set_t & a) {
+            return unrolled([&]<std::size_t... I>(std::index_sequence<I...>) { return (std::size_t {0} + ... + static_cast<std::size_t>(std::popcount(a[I]))); });
+        }
+
+        static constexpr bool empty(const set_t & a) {
+            return unrolled([&]<std::size_t... I>(std::index_sequence<I...>) { return (word_t {0} | ... | a[I]) == 0; });
+        }
+
+        static constexpr bool contains(const set_t & a, std::size_t v) {
+            return (a[v / BitMatrix::word_bits] >> (v % BitMatrix::word_bits)) & 1;
+        }
+
+        static constexpr set_t single(std::size_t v) {
+            set_t s {};
+            s[v / BitMatrix::word_bits] = word_t {1} << (v % BitMatrix::word_bits);
+            return s;
+        }
+
+
+    private:
+        std::size_t n;
+        std::array<set_t, N> rows;
+
+        template <typename F>
+        static constexpr auto unrolled(F f) { return f(std::make_index_sequence<words> {}); }
+
+        /**
+        * @brief first node of a non-empty set
+        */
+        static constexpr std::size_t first(const set_t & a) {
+            std::size_t k = 0;
+            while (a[k] == 0) ++k;
+            return k * BitMatrix::word_bits + std::countr_zero(a[k]);
+        }
+
+        /**
+        * @brief extends a clique of `size` nodes with the candidates (all adjacent to the clique)
+        */
+        bool extend(set_t candidates, int size, int k) const {
+            P2_COUNT(nodes_expanded, 1);
+            P2_DEPTH(size);
+
+            while (size + static_cast<int>(count(candidates)) >= k) {
+                if (size + 1 == k) return true;  // any candidate completes it
+
+                const std::size_t v = first(candidates);
+                candidates = without(candidates, single(v));
+
+                P2_COUNT(edges_scanned, 1);
+                if (extend(both(candidates, rows[v]), size + 1, k)) return true;
+            }
+
+            P2_COUNT(pruned, 1);
+            return false;
+        }
+};
+
+
+
+/**
+ * @brief calls `f` with the graph copied into the smallest FixedGraph it fits in (64, 128 or 256 nodes)
+ * @return false, without calling `f`, if it has more than 256 nodes
+*/
+template <typename Adjacency, typename F>
+bool with_fixed_graph(const Adjacency & adjacency, F f) {
+    if (adjacency.size() <= 64) f(FixedGraph<64> {adjacency});
+    else if (adjacency.size() <= 128) f(FixedGraph<128> {adjacency});
+    else if (adjacency.size() <= 256) f(FixedGraph<256> {adjacency});
+    else return false;
+    return true;
+}
+
+
+
+#endif
@@ -1,85 +1,253 @@
 #include "graph.hpp"
+#include "traversal.hpp"
+#include "clique.hpp"
+#include "bbmc.hpp"
+#include "core.hpp"
+#include "counters.hpp"
+#include "random.hpp"
+#include "parallel.hpp"
 
-#include <random>
+#include <cmath>
+#include <bit>
 #include <functional>
-#include <set>
-#include <limits>
 #include <algorithm>
 #include <array>
 #include <iostream>
-#include <regex>
-#include <cmath>
 
 
 
-std::random_device rd;
-std::uniform_int_distribution<int> dist(1, 100);
-std::mt19937 engine(rd());  // Mersenne twister MT19937
-auto generator = std::bind(dist, engine);
+/**
+ * @brief 64 random bits, each 1 with probability `threshold` / 2^64, drawn from the counter block (a, b, *, stream)
+ *
+ * It compares 64 uniform numbers with the threshold at once, bit by bit from the most significant: a
+ * number is decided at its first bit that differs from the threshold, so about 8 random words are enough
+ * for all of them, instead of a number each.
+*/
+static BitMatrix::word_t bernoulli_word(const Philox & rng, std::uint32_t a, std::uint32_t b, std::uint32_t stream, std::uint64_t threshold) {
+    BitMatrix::word_t result = 0;
+    BitMatrix::word_t undecided = ~BitMatrix::word_t {0};
+    std::array<std::uint64_t, 2> random {};
+
+    for (int bit = 0; bit < 64 && undecided; ++bit) {
+        const std::uint64_t rest = threshold << bit;
+        if (rest == 0) break;  // the rest of the threshold is 0: the undecided numbers are >= it
+
+        if (bit % 2 == 0) random = rng.words({a, b, static_cast<std::uint32_t>(bit / 2), stream});
+        const BitMatrix::word_t r = random[bit % 2];
+
+        if (rest >> 63) {  // 1 in the threshold: the numbers with a 0 are below it
+            result |= undecided & ~r;
+            undecided &= r;
+        }
+        else undecided &= ~r;  // 0 in the threshold: the numbers with a 1 are above it
+    }
+
+    return result;
+}
 
 
-inline bool random(float prob) {
-    if (prob == 1) return true;
-    return (static_cast<float>(generator()) / 100.0) < prob;
+/**
+ * @brief threshold of bernoulli_word for a probability p < 1 (p as a 64-bit fixed-point fraction, exact for any float)
+*/
+static std::uint64_t threshold(float prob) {
+    return static_cast<std::uint64_t>(std::ldexp(static_cast<double>(prob), 64));
 }
 
 
+Graph::Graph(const GraphFile & file) : Graph() {
+    const size_t n = file.size();
+    components = DisjointSets(n);
+    directed_edges = file.edge_count();  // checked against the matrix or lists when the file was opened
+
+    if (file.format() == GraphFile::Format::bits) {
+        edges.assign(n, file.rows());
+        find_components();
+    }
+    else {
+        edges.resize(n);
+        auto offsets = file.offsets();
+        auto targets = file.targets();
+        for (size_t u = 0; u < n; ++u) {
+            for (size_t i = offsets[u]; i < offsets[u + 1]; ++i) {
+                edges.set(u, targets[i]);
+                components.unite(u, targets[i]);
+            }
+        }
+    }
+}
+
 
 void Graph::init(std::initializer_list<std::initializer_list<int>> new_nodes) {
     edges.clear();
+    edges.resize(new_nodes.size());
+    directed_edges = 0;
+    components = DisjointSets(new_nodes.size());
+
+    size_t i = 0;
     for (auto & node : new_nodes) {
-        edges.push_back(node);
+        size_t j = 0;
+        for (auto & edge : node) {
+            if (edge != 0 && i != j) {
+                edges.set(i, j);
+                ++directed_edges;
+                components.unite(i, j);
+            }
+            ++j;
+        }
+        ++i;
     }
+
+    modified();
 }
 
 
 void Graph::add_node(std::vector<int> adj_nodes) {
-    std::vector<int> new_node {};
-
-    int edge;
+    const size_t new_node = size();
+    edges.resize(new_node + 1);  // the new row and column start empty (not linked to self)
+    components.add();
 
     // add adjacent nodes
-    size_t j = 0;  // counter for adj_nodes
-    for (size_t i = 0; i < size(); ++i) {
-        if (adj_nodes.size() > 0 && (static_cast<int>(i) == adj_nodes[j])) {  // there is an edge
-            edge = 1;
-            if (j < adj_nodes.size()) ++j;
-        }
-        else edge = 0;
+    for (auto & j : adj_nodes) {
+        assert(static_cast<size_t>(j) < new_node);
+        if (edges.test(new_node, j)) continue;  // listed twice
+        edges.set(j, new_node);
+        edges.set(new_node, j);
+        directed_edges += 2;
+        components.unite(j, new_node);
+    }
 
-        edges[i].push_back(edge);
-        new_node.push_back(edge);
+    // computed distances are updated in O(n^2), instead of being recomputed on the next query
+    if (distances_valid) {
+        std::vector<weighted_edge_t> adj (adj_nodes.size());
+        for (size_t i = 0; i < adj_nodes.size(); ++i) adj[i] = {adj_nodes[i], 1};
+        insert_node(distance_cache, adj, adj);
     }
+    closure_valid = false;
+}
+
 
-    new_node.push_back(0);  // link to self
+void Graph::add_edge(int u, int v) {
+    assert(u < static_cast<int>(size()));
+    assert(v < static_cast<int>(size()));
+    if (u == v) return;  // nodes aren't linked to self (the clique & degree code relies on an empty diagonal)
+    if (!edges.test(u, v)) directed_edges += 2;
 
-    edges.push_back(new_node);
+    edges.set(u, v);
+    edges.set(v, u);
+    components.unite(u, v);
+
+    // same for the distances, one direction at a time
+    if (distances_valid) {
+        insert_edge(distance_cache, u, v, 1);
+        insert_edge(distance_cache, v, u, 1);
+    }
+    closure_valid = false;
 }
 
 
 
-void RandomUndirectedGraph::add_random_node(float prob_edge) {
-    assert(prob_edge > 0 && prob_edge <= 1);
+void Graph::find_components() {
+    const size_t n = size();
+    components = DisjointSets(n);
 
-    if (edges.empty()) {  // initialize
-        edges.push_back({0});
-        return;
-    }
+    // depth-first, taking the unvisited neighbors of a node a word at a time
+    std::vector<BitMatrix::word_t> unvisited (edges.stride(), 0);
+    for (size_t v = 0; v < n; ++v) unvisited[v / BitMatrix::word_bits] |= BitMatrix::word_t {1} << (v % BitMatrix::word_bits);
 
-    // create new empty node
-    std::vector<int> new_node {};
+    std::vector<int> stack {};
+    for (size_t root = 0; root < n; ++root) {
+        if (!((unvisited[root / BitMatrix::word_bits] >> (root % BitMatrix::word_bits)) & 1)) continue;
+        unvisited[root / BitMatrix::word_bits] &= ~(BitMatrix::word_t {1} << (root % BitMatrix::word_bits));
+        stack.push_back(root);
 
-    // randomly connect nodes to new one
-    for (size_t i = 0; i < edges.size(); ++i) {
-        int edge = static_cast<int>(random(prob_edge));
+        while (!stack.empty()) {
+            const BitMatrix::word_t * row = edges.row(stack.back());
+            stack.pop_back();
 
-        edges[i].push_back(edge);
-        new_node.push_back(edge);
+            for (size_t k = 0; k < edges.stride(); ++k) {
+                BitMatrix::word_t found = row[k] & unvisited[k];
+                unvisited[k] &= ~found;
+                for (; found; found &= found - 1) {
+                    const int v = k * BitMatrix::word_bits + std::countr_zero(found);
+                    components.unite(root, v);
+                    stack.push_back(v);
+                }
+            }
+        }
     }
+}
 
-    new_node.push_back(0);  // it's not connected to itself
-    edges.push_back(new_node);
 
+
+RandomUndirectedGraph::RandomUndirectedGraph(int n, float prob_edge, std::uint64_t seed, unsigned threads) {
+    assert(n > 0);
+    assert(prob_edge > 0 && prob_edge <= 1);
+
+    using word_t = BitMatrix::word_t;
+    constexpr size_t bits = BitMatrix::word_bits;
+
+    edges.resize(n);
+    const Philox rng {seed};
+    const std::uint64_t limit = prob_edge < 1 ? threshold(prob_edge) : 0;
+    const size_t words = (n + bits - 1) / bits;
+
+    // upper triangle: the words of row i from the diagonal on (the node isn't connected to itself)
+    parallel_for(0, n, [&](size_t i) {
+        word_t * row = edges.row(i);
+        for (size_t k = i / bits; k < words; ++k) {
+            word_t mask = ~word_t {0};
+            if (k == i / bits) mask = (mask << (i % bits)) << 1;
+            if (k == words - 1 && n % bits != 0) mask &= (word_t {1} << (n % bits)) - 1;
+            if (mask) row[k] = prob_edge < 1 ? bernoulli_word(rng, i, k, 0, limit) & mask : mask;
+        }
+    }, threads);
+
+    // lower triangle: mirror the upper one a 64 x 64 tile at a time. Column block I only writes its own rows
+    parallel_for(0, words, [&](size_t I) {
+        std::array<word_t, bits> tile;
+        for (size_t J = 0; J <= I; ++J) {
+            for (size_t r = 0; r < bits; ++r) tile[r] = J * bits + r < size() ? edges.row(J * bits + r)[I] : 0;
+            transpose(tile);
+            for (size_t r = 0; r < bits && I * bits + r < size(); ++r) edges.row(I * bits + r)[J] |= tile[r];
+        }
+    }, threads);
+
+    for (size_t i = 0; i < size(); ++i) directed_edges += edges.count(i);
+    find_components();
+}
+
+
+CSRGraph RandomUndirectedGraph::sparse(int n, float prob_edge, std::uint64_t seed, unsigned threads) {
+    assert(n > 0);
+    assert(prob_edge > 0 && prob_edge <= 1);
+
+    // jump straight to the next edge of each row: the gap between edges follows a geometric distribution.
+    // Row i draws its gaps from the counter block (i, draw, 0, 1), so blocks of rows can be generated in parallel
+    const Philox rng {seed};
+    const double log_q = std::log1p(-static_cast<double>(prob_edge));
+    constexpr int rows_per_block = 1024;
+    const int blocks = (n + rows_per_block - 1) / rows_per_block;
+    std::vector<std::vector<std::pair<int, int>>> block_edges (blocks);
+
+    parallel_for(0, blocks, [&](size_t b) {
+        auto & edge_list = block_edges[b];
+        for (int i = b * rows_per_block; i < std::min<int>(n, (b + 1) * rows_per_block); ++i) {
+            std::uint32_t draw = 0;
+            auto gap = [&]() {
+                const double u = unit(rng.words({static_cast<std::uint32_t>(i), draw++, 0, 1})[0]);
+                return std::min<double>(std::floor(std::log1p(-u) / log_q), n);
+            };
+
+            for (long long j = i + 1 + gap(); j < n; j += 1 + gap()) {
+                edge_list.emplace_back(i, j);
+            }
+        }
+    }, threads);
+
+    std::vector<std::pair<int, int>> edge_list {};
+    for (auto & block : block_edges) edge_list.insert(edge_list.end(), block.begin(), block.end());
+
+    return CSRGraph(n, edge_list);
 }
 
 
@@ -88,191 +256,259 @@ void RandomUndirectedGraph::add_random_node(float prob_edge) {
 /* PATH(u,v) */
 
 
-bool Graph::_path_dfs(int u, int v, std::set<int> & visited) const {
-    if (u == v) return true;
-    visited.insert(u);
+// scratch space for the PATH traversals, reused by every query of the thread
+static thread_local Traversal traversal {};
+static thread_local MultiSourceBFS<> batch_traversal {};
 
-    // check adjacent nodes
-    for (size_t i = 0; i < edges.size(); ++i) {
-        if (edges[i][u] == 1 && !visited.contains(i)) {
-            if (_path_dfs(i, v, visited)) return true;
-        }
-    }
 
-    return false;
+bool Graph::path_dfs(int u, int v) const {
+    assert(u < static_cast<int>(size()));
+    assert(v < static_cast<int>(size()));
+
+    return traversal.dfs(*this, u, v);
 }
 
-bool Graph::path_dfs(int u, int v) const {
-    // wrapper that initializes the set
-    assert(u < static_cast<int>(edges.size()));
-    assert(v < static_cast<int>(edges.size()));
 
-    std::set<int> visited {};
-    return _path_dfs(u, v, visited);
+bool Graph::path_bfs(int u, int v) const {
+    assert(u < static_cast<int>(size()));
+    assert(v < static_cast<int>(size()));
+
+    return traversal.bfs(*this, u, v);
 }
 
 
+std::vector<bool> Graph::path_many(std::span<const std::pair<int, int>> queries) const {
+    return batch_traversal.path_many(*this, queries);
+}
+
+
+ReachableSets Graph::reachable_from(std::span<const int> sources) const {
+    return batch_traversal.reachable_from(*this, sources);
+}
+
 
 
-bool Graph::path_fw(int u, int v) const {
-    assert(u < static_cast<int>(edges.size()));
-    assert(v < static_cast<int>(edges.size()));
+
+bool Graph::path_fw(int u, int v, unsigned threads) const {
+    assert(u < static_cast<int>(size()));
+    assert(v < static_cast<int>(size()));
 
     if (u == v) return true;
 
-    constexpr int infinity {std::numeric_limits<int>::max()};
+    return distances(threads).reachable(u, v);
+}
 
-    std::vector<std::vector<int>> distance {};
 
-    // initialize distances
-    for (size_t u = 0; u < edges.size(); ++u) {
-        distance.push_back({});
-        distance[u].reserve(edges.size());
-        for (size_t v = 0; v < edges.size(); ++v) {
-            int d;
-            if (u == v) {
-                d = 0;
-            }
-            else if (edges[u][v] != 0) {
-                d = edges[u][v];
-            }
-            else d = infinity;
+const DistanceMatrix & Graph::distances(unsigned threads) const {
+    if (distances_valid) return distance_cache;
 
-            distance[u].push_back(d);
-        }
+    // initialize distances (1 per edge)
+    distance_cache = DistanceMatrix(size());
+    for (size_t u = 0; u < size(); ++u) {
+        for_each_bit(edges.row(u), edges.stride(), [&](size_t v) { distance_cache.at(u, v) = 1; });
     }
 
     // compute distances
-    for (size_t k = 0; k < edges.size(); ++k) {
-        for (size_t i = 0; i < edges.size(); ++i) {
-            for (size_t j = 0; j < edges.size(); ++j) {
-                if ((distance[i][k] == infinity) || (distance[k][j] == infinity)) continue;
-                distance[i][j] = std::min(distance[i][j], distance[i][k] + distance[k][j]);
-            }
-        }
-    }
+    floyd_warshall(distance_cache, threads);
+    distances_valid = true;
 
-    return distance[u][v] < infinity;
+    return distance_cache;
 }
 
 
-/* K_CLIQUE(k) */
+bool Graph::path_uf(int u, int v) const {
+    assert(u < static_cast<int>(size()));
+    assert(v < static_cast<int>(size()));
+
+    return components.same(u, v);
+}
+
+
+bool Graph::path_tc(int u, int v, unsigned threads) const {
+    assert(u < static_cast<int>(size()));
+    assert(v < static_cast<int>(size()));
+
+    return closure(threads).reachable(u, v);
+}
+
+
+const TransitiveClosure & Graph::closure(unsigned threads) const {
+    if (closure_valid) return closure_cache;
 
+    closure_cache = TransitiveClosure(edges, threads);
+    closure_valid = true;
 
-inline int Graph::degree(int i) const {
-    return std::count_if(edges[i].begin(), edges[i].end(), [](int i) { return i > 0; });
+    return closure_cache;
 }
 
 
+/* K_CLIQUE(k) */
+
+
 bool Graph::k_clique(int k) const {
+    if (k <= 0) return true;
+    return static_cast<int>(max_clique(k).size()) >= k;
+}
+
+
+bool Graph::k_clique_bbmc(int k) const {
+    if (k <= 0) return true;
+
+    // a clique of k nodes only uses nodes of the (k - 1)-core
+    const std::vector<int> core = k_core(edges, k - 1);
+    if (static_cast<int>(core.size()) < k) return false;
+
+    ColoringCliqueSearch search {induced_subgraph(edges, core), k};
+    return static_cast<int>(search.run().size()) >= k;
+}
+
+
+bool Graph::k_clique_parallel(int k, unsigned threads) const {
+    if (k <= 0) return true;
+    return static_cast<int>(max_clique(k, threads).size()) >= k;
+}
+
+
+std::vector<int> Graph::max_clique(int target, unsigned threads) const {
+    auto search = [&](const BitMatrix & adjacency) {
+        if (threads != 1) return parallel_max_clique(adjacency, target, threads);
+
+        CliqueSearch search {adjacency, target};
+        return search.run();
+    };
+
+    if (target <= 1) return search(edges);
+
+    // with a target, only the nodes of the (target - 1)-core matter: search on that subgraph, usually much smaller
+    const std::vector<int> core = k_core(edges, target - 1);
+    if (static_cast<int>(core.size()) < target) return {};
+
+    std::vector<int> clique = search(induced_subgraph(edges, core));
+    for (auto & v : clique) v = core[v];  // back to the original labels (still sorted)
+
+    return clique;
+}
+
+
+std::uint64_t Graph::count_cliques(int k, unsigned threads) const {
+    return ::count_cliques(edges, k, threads);
+}
+
+
+std::uint64_t Graph::list_cliques(int k, const clique_visitor_t & visit, unsigned threads) const {
+    return ::list_cliques(edges, k, visit, threads);
+}
+
+
+bool Graph::k_clique_bt(int k) const {
+    if (k <= 0) return true;
+
+    // every node of the (k - 1)-core has enough neighbors, the rest can't be in the clique
+    const std::vector<int> core = k_core(edges, k - 1);
+
     std::vector<int> subgraph {};
-    return _k_clique(0, subgraph, k);
+    return _k_clique(0, core, subgraph, k);
 }
 
 
 
-bool Graph::_k_clique(int i, std::vector<int> & subgraph, int k) const {
-    for (size_t j = i; j < size(); ++j) {
-        if (degree(i) >= k - 1) {
-            subgraph.push_back(j);  // add current node to clique subgraph
+bool Graph::_k_clique(size_t i, const std::vector<int> & nodes, std::vector<int> & subgraph, int k) const {
+    P2_COUNT(nodes_expanded, 1);
+    P2_DEPTH(subgraph.size());
 
-            if (is_connected(j, subgraph)) {  // new node forms clique
-                if (static_cast<int>(subgraph.size()) < k) {  // continue searching
-                    _k_clique(j, subgraph, k);
-                }
-                else {
-                    return true;
-                }
-            }
+    for (size_t j = i; j < nodes.size(); ++j) {
+        if (static_cast<int>(subgraph.size() + nodes.size() - j) < k) {  // not enough nodes left
+            P2_COUNT(pruned, 1);
+            return false;
         }
+
+        subgraph.push_back(nodes[j]);  // add current node to clique subgraph
+
+        if (is_connected(nodes[j], subgraph)) {  // new node forms clique
+            if (static_cast<int>(subgraph.size()) == k) return true;
+            if (_k_clique(j + 1, nodes, subgraph, k)) return true;  // continue searching
+        }
+
+        subgraph.pop_back();
     }
 
     return false;
 }
 
 
-bool Graph::is_connected(int i, std::vector<int> & list) const {
+bool Graph::is_connected(int i, const std::vector<int> & list) const {
     if (list.size() == 0) return true;
+    P2_COUNT(edges_scanned, list.size());
+
+    // bitset of the nodes in the list (except i), checked against the row of i in one pass
+    thread_local std::vector<BitMatrix::word_t> mask;
+    mask.assign(edges.stride(), 0);
 
     for (auto & j : list) {
-        if (edges[i][j] == 0) {
-            if (i == j) continue;
-            return false;
-        }
+        if (i == j) continue;
+        mask[j / BitMatrix::word_bits] |= BitMatrix::word_t {1} << (j % BitMatrix::word_bits);
     }
-    return true;
+
+    return edges.covers(i, mask.data());
 }
 
 
 
-bool Graph::is_clique(std::vector<int> & graph) const {
-    for (size_t i = 0; i < graph.size(); ++i) {
-        for (size_t j = i + 1; j < graph.size(); ++j) {
-            if (edges[i][j] == 0) {
-                return false;
-            }
-        }
-    }
+bool Graph::is_clique(const std::vector<int> & graph) const {
+    if (graph.size() < 2) return true;
 
-    return true;
-}
+    thread_local std::vector<BitMatrix::word_t> mask;
+    mask.assign(edges.stride(), 0);
 
+    for (auto & i : graph) {
+        mask[i / BitMatrix::word_bits] |= BitMatrix::word_t {1} << (i % BitMatrix::word_bits);
+    }
 
+    // every node must be connected to every other node of the subgraph
+    for (auto & i : graph) {
+        const auto bit = BitMatrix::word_t {1} << (i % BitMatrix::word_bits);
+        mask[i / BitMatrix::word_bits] &= ~bit;
+        const bool connected = edges.covers(i, mask.data());
+        mask[i / BitMatrix::word_bits] |= bit;
 
+        if (!connected) return false;
+    }
 
-/* K-SAT to K-Clique */
+    return true;
+}
 
-std::tuple<Graph, size_t> sat_to_clique(const std::string & problem) {
-    // TODO: validate problem format
 
-    // extract vars
-    std::vector<std::string> vars;
 
-    const std::regex re_vars(R"((-?[a-z]))");
-    std::smatch match;
 
-    std::sregex_iterator start {problem.cbegin(), problem.cend(), re_vars};
-    std::sregex_iterator end;
+/* K-SAT to K-Clique */
 
-    for (auto i = start; i != end; ++i) {
-        vars.push_back(i->str());
-        // std::cout << i->str() << ", ";
+std::tuple<Graph, size_t> sat_to_clique(const CNF & cnf) {
+    // one node per literal occurrence, grouped by clause
+    std::vector<int> literal (cnf.literals.begin(), cnf.literals.end());
+    std::vector<size_t> clause (literal.size());
+    for (size_t c = 0; c < cnf.size(); ++c) {
+        for (size_t i = cnf.offsets[c]; i < cnf.offsets[c + 1]; ++i) clause[i] = c;
     }
 
-    const auto k = static_cast<size_t>(std::sqrt(vars.size()));
-    assert(vars.size() == k * k);  // check k perfect square (correct number of vars)
-
     // generate graph
     Graph g {};
-    std::vector<std::string> in_vars;
-
-    for (size_t i = 0; i < vars.size(); ++i) {
+    for (size_t i = 0; i < literal.size(); ++i) {
         std::vector<int> adj_nodes {};
+        P2_COUNT(edges_scanned, i);
 
-        // compute inverse of element
-        std::string el = vars[i];
-        std::string not_el;
-        if (el[0] == '-') {
-            not_el = el[1];
-        }
-        else not_el = '-' + el;
-
-        // connect to rest of graph
-        for (size_t j = 0; j < in_vars.size(); ++j) {
-            if (i / k == j / k) continue;  // don't connect if same group
-            if (in_vars[j] != not_el) adj_nodes.push_back(j);
+        // connect to the literals of other clauses, unless they're the inverse of this one
+        for (size_t j = 0; j < i; ++j) {
+            if (clause[i] == clause[j]) continue;  // don't connect if same group
+            if (literal[j] != -literal[i]) adj_nodes.push_back(j);
         }
 
         g.add_node(adj_nodes);
-
-        in_vars.push_back(std::move(vars[i]));
     }
 
-    // std::cout << g << "\n";
-    // print_v(in_vars);
-    // std::cout << "\n";
+    P2_COUNT(bytes_allocated, g.adjacency().bytes());
 
-    return {g, k};
+    // a clique with a node from every clause sets all its literals to true
+    return {g, cnf.size()};
 }
 
 
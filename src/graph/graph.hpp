@@ -3,35 +3,71 @@
 
 
 #include <vector>
+#include <span>
+#include <utility>
 #include <cassert>
 #include <ostream>
 #include <iterator>
-#include <set>
 #include <initializer_list>
 #include <tuple>
+#include <string>
+#include <cstdint>
+
+#include "bitmatrix.hpp"
+#include "csr.hpp"
+#include "apsp.hpp"
+#include "closure.hpp"
+#include "msbfs.hpp"
+#include "components.hpp"
+#include "graphfile.hpp"
+#include "kclist.hpp"  // clique_visitor_t
+#include "cnf.hpp"
 
 
 
 class Graph {
     public:
-        Graph(): edges {} { }
+        Graph(): edges {}, directed_edges {0}, components {}, distance_cache {}, distances_valid {false}, closure_cache {}, closure_valid {false} { }
+
+        /**
+        * @brief loads a graph file (the matrix rows are copied from the mapping in one block, adjacency lists are converted)
+        */
+        explicit Graph(const GraphFile & file);
 
         /* setup functions */
 
         /**
-        * @brief initializes the graph with the specified adjacency matrix
+        * @brief initializes the graph with the specified adjacency matrix (any non-zero value off the diagonal is an edge)
         */
         void init(std::initializer_list<std::initializer_list<int>> new_nodes);
 
         /**
-        * @brief adds a node to the graph, given the adjacency vector
+        * @brief adds a node to the graph, given the sorted list of nodes it's connected to.
+        * Computed distances are kept up to date, in O(n^2)
         */
         void add_node(std::vector<int> node);
 
+        /**
+        * @brief adds an undirected edge between u and v (nothing if u == v, nodes aren't linked to self).
+        * Computed distances are kept up to date, in O(n^2)
+        */
+        void add_edge(int u, int v);
+
         /**
         * @brief clears the graph
         */
-        void clear() { edges.clear(); }
+        void clear() {
+            edges.clear();
+            directed_edges = 0;
+            components.clear();
+            modified();
+        }
+
+        /**
+        * @brief writes the graph to a binary file, as a bit-packed matrix (see GraphFile)
+        * @throws std::runtime_error if the file can't be written
+        */
+        void save(const std::string & path) const { GraphFile::save(path, edges); }
 
 
         /**
@@ -39,24 +75,44 @@ class Graph {
         */
         size_t size() const { return edges.size(); }
 
+        /**
+        * @brief checks if there is an edge from u to v
+        */
+        bool has_edge(int u, int v) const { return edges.test(u, v); }
+
+        /**
+         * @brief computes the degree of a node
+        */
+        int degree(int i) const { return edges.count(i); }
+
+        /**
+        * @brief returns the number of (directed) edges, kept as edges are added (the sum of the degrees, in O(1))
+        */
+        size_t edge_count() const { return directed_edges; }
+
+        /**
+        * @brief returns the adjacency matrix
+        */
+        const BitMatrix & adjacency() const { return edges; }
+
 
         /* overload << operator */
         friend std::ostream & operator << (std::ostream & out, const Graph & graph) {
+            const size_t n = graph.size();
+
             out << "[";
-            for (size_t i = 0; i < graph.edges.size(); ++i) {
+            for (size_t i = 0; i < n; ++i) {
                 // print connected nodes
                 out << "[";
-                size_t j = 0;
-                for (auto & node : graph.edges[i]) {
-                    out << node;
-                    if (j < graph.edges[i].size() - 1) {  // not last element
+                for (size_t j = 0; j < n; ++j) {
+                    out << graph.edges.test(i, j);
+                    if (j < n - 1) {  // not last element
                         out << ", ";
                     }
-                    ++j;
                 }
                 out << "]";
 
-                if (i < graph.edges.size() - 1) {  // not last element
+                if (i < n - 1) {  // not last element
                     out << ", ";
                 }
             }
@@ -75,43 +131,138 @@ class Graph {
 
 
         /**
-        * @brief PATH(u, v) using Floyd-Warshall
+        * @brief PATH(u, v) using direction-optimizing Breadth First Search
+        */
+        bool path_bfs(int u, int v) const;
+
+
+        /**
+        * @brief PATH(u, v) using Floyd-Warshall. The distances are computed once (on `threads` threads, 0 = one
+        * per core) and reused by later queries
+        */
+        bool path_fw(int u, int v, unsigned threads = 1) const;
+
+        /**
+        * @brief shortest path lengths between all pairs of nodes (computed on the first call, on `threads` threads,
+        * until the graph changes)
+        */
+        const DistanceMatrix & distances(unsigned threads = 1) const;
+
+
+        /**
+        * @brief PATH(u, v) using the connected components, which are kept up to date as nodes and edges are added.
+        * Near O(1). Only valid for undirected graphs
         */
-        bool path_fw(int u, int v) const;
+        bool path_uf(int u, int v) const;
+
+
+        /**
+        * @brief PATH(u, v) using the transitive closure (one bit test once the closure is built, on `threads` threads,
+        * 0 = one per core)
+        */
+        bool path_tc(int u, int v, unsigned threads = 1) const;
+
+        /**
+        * @brief reachability between all pairs of nodes (computed on the first call, on `threads` threads, until the
+        * graph changes)
+        */
+        const TransitiveClosure & closure(unsigned threads = 1) const;
+
+
+        /**
+        * @brief PATH(u, v) for every pair of a batch, using multi-source BFS: the traversals of up to 256 sources
+        * advance together, sharing every adjacency scan (see MultiSourceBFS)
+        */
+        std::vector<bool> path_many(std::span<const std::pair<int, int>> queries) const;
+
+        /**
+        * @brief nodes reachable from each of `sources` (row i for sources[i]), using multi-source BFS
+        */
+        ReachableSets reachable_from(std::span<const int> sources) const;
 
 
         /* K-CLIQUE implementations */
 
         /**
-         * @brief checks if there is a complete subgraph of size k
+         * @brief checks if there is a complete subgraph of size k (Bron–Kerbosch, stops at the first one found)
         */
         bool k_clique(int k) const;
 
+        /**
+         * @brief checks if there is a complete subgraph of size k, using plain backtracking
+        */
+        bool k_clique_bt(int k) const;
+
+        /**
+         * @brief checks if there is a complete subgraph of size k, using branch and bound with coloring bounds (BBMC)
+        */
+        bool k_clique_bbmc(int k) const;
+
+        /**
+         * @brief checks if there is a complete subgraph of size k, searching with `threads` threads (0 = one per core)
+        */
+        bool k_clique_parallel(int k, unsigned threads) const;
+
+        /**
+         * @brief finds a complete subgraph of maximum size, or the first one of `target` nodes (0 = no target).
+         * With more than 1 thread (0 = one per core) the search is spread over a work-stealing pool
+         * @return sorted nodes of the clique. With a target, it has fewer nodes (and isn't necessarily maximum) if there is no clique of `target` nodes
+        */
+        std::vector<int> max_clique(int target = 0, unsigned threads = 1) const;
+
+        /**
+         * @brief number of complete subgraphs of size k (kClist, see count_cliques), on `threads` threads (0 = one per core)
+        */
+        std::uint64_t count_cliques(int k, unsigned threads = 1) const;
+
+        /**
+         * @brief passes every complete subgraph of size k to `visit` as it's found (see list_cliques)
+         * @return number of cliques
+        */
+        std::uint64_t list_cliques(int k, const clique_visitor_t & visit, unsigned threads = 1) const;
+
 
     protected:  // can be accessed by children
-        std::vector<std::vector<int>> edges;  // adjacency matrix (1 = edge, 0 = no edge)
+        BitMatrix edges;  // adjacency matrix (1 = edge, 0 = no edge)
+        size_t directed_edges;  // bits set in the matrix, see edge_count()
 
-        bool _path_dfs(int u, int v, std::set<int> & visited) const;
+        mutable DisjointSets components;  // connected components (finds compress paths, hence mutable)
 
+        mutable DistanceMatrix distance_cache;  // all-pairs distances, see distances()
+        mutable bool distances_valid;
 
-        /* K-CLIQUE implementations */
+        mutable TransitiveClosure closure_cache;  // see closure()
+        mutable bool closure_valid;
 
-        bool _k_clique(int i, std::vector<int> & list, int k) const;
+        /**
+        * @brief computes the connected components from scratch, in O(n^2 / 64) (a traversal over the matrix rows)
+        */
+        void find_components();
 
         /**
-         * @brief checks if a subgraph is complete
+        * @brief must be called after changing the edges, to drop the cached results
         */
-        bool is_clique(std::vector<int> & list) const;
+        void modified() {
+            distances_valid = false;
+            closure_valid = false;
+        }
+
+        /* K-CLIQUE implementations */
 
         /**
-         * @brief checks if a node i is connected to the rest of nodes in the list
+         * @brief extends the clique in `list` with nodes[i..], trying them in order
         */
-        bool is_connected(int i, std::vector<int> & list) const;
+        bool _k_clique(size_t i, const std::vector<int> & nodes, std::vector<int> & list, int k) const;
 
         /**
-         * @brief computes the degree of a node
+         * @brief checks if a subgraph is complete
+        */
+        bool is_clique(const std::vector<int> & list) const;
+
+        /**
+         * @brief checks if a node i is connected to the rest of nodes in the list
         */
-        inline int degree(int i) const;
+        bool is_connected(int i, const std::vector<int> & list) const;
 
 
         /* SAT SOLVER implementations */
@@ -123,22 +274,24 @@ class Graph {
 
 class RandomUndirectedGraph : public Graph {
     public:
+        /**
+        * @brief generates a random graph where every edge is present with probability `prob_edge`, independently
+        *
+        * The edges come from a counter-based generator (Philox) keyed by `seed`: every word of the matrix is
+        * drawn on its own, so the graph is the same for a seed whatever the number of threads (0 = one per core)
+        */
         RandomUndirectedGraph(
             int n,  // number of nodes
-            float prob_edge  // probability of an edge in between two nodes
-            // edges is already initialized by the constructor of the parent class
-        ) {
-            assert(n > 0);
-
-            for (int i = 0; i < n; ++i) {
-                add_random_node(prob_edge);
-            }
-        }
+            float prob_edge,  // probability of an edge in between two nodes
+            std::uint64_t seed,
+            unsigned threads = 1
+        );
 
         /**
-        * @brief adds a randomized node to the graph
+        * @brief generates a random graph with the same distribution directly in CSR format, without building
+        * the adjacency matrix. Time and memory are O(n + edges)
         */
-        void add_random_node(float prob_edge);
+        static CSRGraph sparse(int n, float prob_edge, std::uint64_t seed, unsigned threads = 1);
 
 };
 
@@ -147,10 +300,12 @@ class RandomUndirectedGraph : public Graph {
 /* SAT SOLVER implementations */
 
 /**
- * @brief Transforms a K-SAT problem, using parenthesis, * (AND), + (OR) & - (NOT), into a k-clique graph
+ * @brief Transforms a K-SAT problem into a k-clique graph: one node per literal, connected to the literals of
+ * other clauses that aren't its inverse. k is the number of clauses. The matrix takes O(n^2) time and memory:
+ * SatGraph is the same graph without building it
  * @return Tuple w/ graph and k
 */
-std::tuple<Graph, size_t> sat_to_clique(const std::string & problem);
+std::tuple<Graph, size_t> sat_to_clique(const CNF & cnf);
 
 
 
@@ -0,0 +1,241 @@
+#include "graphfile.hpp"
+
+#include <fstream>
+#include <stdexcept>
+#include <cstring>
+#include <vector>
+#include <array>
+#include <algorithm>
+
+
+
+static constexpr char magic[8] = "P2GRAPH";
+static constexpr std::uint32_t byte_order = 0x01020304;
+
+static constexpr std::uint64_t fnv_offset = 0xcbf29ce484222325;
+static constexpr std::uint64_t fnv_prime = 0x100000001b3;
+
+
+/**
+ * @brief continues a checksum with more words
+*/
+static std::uint64_t checksum_words(std::uint64_t h, const char * data, std::size_t bytes) {
+    for (std::size_t i = 0; i < bytes; i += sizeof(std::uint64_t)) {
+        std::uint64_t word;
+        std::memcpy(&word, data + i, sizeof(word));
+        h = (h ^ word) * fnv_prime;
+    }
+    return h;
+}
+
+
+/**
+ * @brief bytes of a csr payload, padded to 8 bytes
+*/
+static std::size_t csr_bytes(std::size_t n, std::size_t edges) {
+    const std::size_t bytes = (n + 1) * sizeof(std::uint64_t) + edges * sizeof(std::int32_t);
+    return (bytes + 7) / 8 * 8;
+}
+
+
+static GraphFileHeader make_header(GraphFile::Format format, std::size_t n, std::size_t stride, std::size_t edges, std::size_t payload) {
+    GraphFileHeader header {};
+    std::memcpy(header.magic, magic, sizeof(magic));
+    header.version = GraphFile::version;
+    header.format = static_cast<std::uint32_t>(format);
+    header.n = n;
+    header.stride = stride;
+    header.edges = edges;
+    header.payload = payload;
+    header.byte_order = byte_order;
+    return header;
+}
+
+
+static void write(std::ofstream & out, const void * data, std::size_t bytes) {
+    out.write(static_cast<const char *>(data), bytes);
+}
+
+
+/**
+ * @brief checks that the matrix of a bits file holds as BitMatrix expects: no bits past n, nothing on the diagonal,
+ * symmetric and with the edges of the header. The symmetry is checked a 64 x 64 tile at a time, against the
+ * transpose of the mirror tile
+ * @return what's wrong, or nullptr
+*/
+static const char * matrix_error(const GraphFile & file) {
+    using word_t = GraphFile::word_t;
+    constexpr std::size_t B = BitMatrix::word_bits;
+    const std::size_t n = file.size();
+    const std::size_t used = (n + B - 1) / B;  // words with bits of nodes
+
+    std::size_t edges = 0;
+    for (std::size_t i = 0; i < n; ++i) {
+        const word_t * r = file.row(i);
+        if ((r[i / B] >> (i % B)) & 1) return "self-loop";
+        if (n % B != 0 && (r[used - 1] >> (n % B)) != 0) return "bits past the last node";
+        for (std::size_t k = used; k < file.stride(); ++k) {
+            if (r[k] != 0) return "bits past the last node";
+        }
+        edges += BitMatrix::count(r, file.stride());
+    }
+    if (edges != file.edge_count()) return "bad edge count";
+
+    std::array<word_t, 64> tile, mirror;
+    for (std::size_t bi = 0; bi < used; ++bi) {
+        for (std::size_t bj = bi; bj < used; ++bj) {
+            for (std::size_t r = 0; r < B; ++r) {
+                tile[r] = bi * B + r < n ? file.row(bi * B + r)[bj] : 0;
+                mirror[r] = bj * B + r < n ? file.row(bj * B + r)[bi] : 0;
+            }
+            transpose(mirror);
+            if (tile != mirror) return "asymmetric matrix";
+        }
+    }
+    return nullptr;
+}
+
+
+/**
+ * @brief checks that the lists of a csr file hold as CSRGraph expects: sorted, without repeated nodes or self-loops,
+ * and symmetric (every edge is found in the list of the other node). The nodes must be in range
+ * @return what's wrong, or nullptr
+*/
+static const char * lists_error(const GraphFile & file) {
+    auto offsets = file.offsets();
+    auto targets = file.targets();
+    auto list = [&](std::size_t u) { return targets.subspan(offsets[u], offsets[u + 1] - offsets[u]); };
+
+    for (std::size_t u = 0; u < file.size(); ++u) {
+        auto adj = list(u);
+        for (std::size_t i = 0; i < adj.size(); ++i) {
+            if (static_cast<std::size_t>(adj[i]) == u) return "self-loop";
+            if (i > 0 && adj[i - 1] >= adj[i]) return "unsorted adjacency lists";
+        }
+    }
+    for (std::size_t u = 0; u < file.size(); ++u) {
+        for (int v : list(u)) {
+            auto back = list(v);
+            if (!std::binary_search(back.begin(), back.end(), static_cast<std::int32_t>(u))) return "asymmetric adjacency lists";
+        }
+    }
+    return nullptr;
+}
+
+
+
+std::uint64_t GraphFile::checksum(const char * data, std::size_t bytes) {
+    return checksum_words(fnv_offset, data, bytes);
+}
+
+
+
+GraphFile::GraphFile(const std::string & path) : file {path}, header {}, payload {nullptr} {
+    const std::string_view data = file.view();
+    const auto invalid = [&path](const std::string & reason) {
+        return std::runtime_error("'" + path + "' is not a valid graph file (" + reason + ")");
+    };
+
+    if (data.size() < sizeof(header)) throw invalid("too short");
+    std::memcpy(&header, data.data(), sizeof(header));
+    payload = data.data() + sizeof(header);
+
+    if (std::memcmp(header.magic, magic, sizeof(magic)) != 0) throw invalid("bad magic number");
+    if (header.version != version) throw invalid("unsupported version " + std::to_string(header.version));
+    if (header.byte_order != byte_order) throw invalid("written with another byte order");
+    if (header.payload != data.size() - sizeof(header)) throw invalid("truncated");
+
+    // the payload must be exactly what the header describes
+    if (format() == Format::bits) {
+        if (header.stride != BitMatrix::words_for(header.n) || header.payload != header.n * header.stride * sizeof(word_t)) {
+            throw invalid("bad matrix size");
+        }
+    }
+    else if (format() == Format::csr) {
+        if (header.payload != csr_bytes(header.n, header.edges)) throw invalid("bad adjacency lists size");
+    }
+    else throw invalid("unknown format " + std::to_string(header.format));
+
+    if (checksum(payload, header.payload) != header.checksum) throw invalid("checksum mismatch");
+
+    // cheap next to the checksum, and the graphs rely on it (bits past n are never cleared, lists aren't bounds checked)
+    if (format() == Format::bits) {
+        if (const char * error = matrix_error(*this)) throw invalid(error);
+    }
+    else {
+        auto off = offsets();
+        if (off.front() != 0 || off.back() != header.edges) throw invalid("bad offsets");
+        for (std::size_t u = 0; u < size(); ++u) {
+            if (off[u] > off[u + 1]) throw invalid("bad offsets");
+        }
+        for (auto & v : targets()) {
+            if (v < 0 || static_cast<std::size_t>(v) >= size()) throw invalid("bad node " + std::to_string(v));
+        }
+        if (const char * error = lists_error(*this)) throw invalid(error);
+    }
+}
+
+
+
+void GraphFile::save(const std::string & path, const BitMatrix & matrix) {
+    const std::size_t n = matrix.size();
+    const std::size_t stride = BitMatrix::words_for(n);  // rows of the matrix can be wider (spare capacity)
+    const std::size_t row_bytes = stride * sizeof(word_t);
+
+    std::size_t edges = 0;
+    std::uint64_t h = fnv_offset;
+    for (std::size_t i = 0; i < n; ++i) {
+        edges += matrix.count(i);
+        h = checksum_words(h, reinterpret_cast<const char *>(matrix.row(i)), row_bytes);
+    }
+
+    GraphFileHeader header = make_header(Format::bits, n, stride, edges, n * row_bytes);
+    header.checksum = h;
+
+    std::ofstream out {path, std::ios::binary | std::ios::trunc};
+    if (!out) throw std::runtime_error("can't write '" + path + "'");
+
+    write(out, &header, sizeof(header));
+    if (matrix.stride() == stride) write(out, matrix.row(0), n * row_bytes);  // contiguous
+    else {
+        for (std::size_t i = 0; i < n; ++i) write(out, matrix.row(i), row_bytes);
+    }
+
+    if (!out.flush()) throw std::runtime_error("can't write '" + path + "'");
+}
+
+
+void GraphFile::save(const std::string & path, std::span<const std::size_t> offsets, std::span<const int> targets) {
+    static_assert(sizeof(int) == sizeof(std::int32_t));
+
+    const std::size_t n = offsets.size() - 1;
+    const std::vector<std::uint64_t> offsets_64 (offsets.begin(), offsets.end());
+    const std::size_t payload = csr_bytes(n, targets.size());
+    const std::size_t padding = payload - offsets_64.size() * sizeof(std::uint64_t) - targets.size_bytes();
+    const char zeros[8] {};
+
+    // the targets start at a multiple of 8 bytes, so the checksum can run over both parts in turn
+    std::uint64_t h = checksum_words(fnv_offset, reinterpret_cast<const char *>(offsets_64.data()), offsets_64.size() * sizeof(std::uint64_t));
+    if (padding == 0) h = checksum_words(h, reinterpret_cast<const char *>(targets.data()), targets.size_bytes());
+    else {
+        const std::size_t whole = targets.size_bytes() - (8 - padding);
+        h = checksum_words(h, reinterpret_cast<const char *>(targets.data()), whole);
+
+        char last[8] {};
+        std::memcpy(last, reinterpret_cast<const char *>(targets.data()) + whole, 8 - padding);
+        h = checksum_words(h, last, 8);
+    }
+
+    GraphFileHeader header = make_header(Format::csr, n, 0, targets.size(), payload);
+    header.checksum = h;
+
+    std::ofstream out {path, std::ios::binary | std::ios::trunc};
+    if (!out) throw std::runtime_error("can't write '" + path + "'");
+
+    write(out, &header, sizeof(header));
+    write(out, offsets_64.data(), offsets_64.size() * sizeof(std::uint64_t));
+    write(out, targets.data(), targets.size_bytes());
+    write(out, zeros, padding);
+
+    if (!out.flush()) throw std::runtime_error("can't write '" + path + "'");
+}
@@ -0,0 +1,129 @@
+#ifndef GRAPHFILE_HPP
+#define GRAPHFILE_HPP
+
+
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <span>
+
+#include "bitmatrix.hpp"
+#include "mappedfile.hpp"
+
+
+
+/**
+ * @brief header of a binary graph file, followed by `payload` bytes
+ *
+ * The payload is either the rows of the adjacency matrix as in BitMatrix (`stride` words per row, the
+ * bits past n are 0), or the adjacency lists in CSR format (n + 1 64-bit offsets, then `edges` 32-bit
+ * targets, padded to 8 bytes). Numbers are stored in the byte order of the machine that wrote the file.
+ * The header takes 64 bytes, so the payload of a mapped file is aligned to a cache line.
+*/
+struct GraphFileHeader {
+    char magic[8];  // "P2GRAPH" and a 0
+    std::uint32_t version;
+    std::uint32_t format;  // GraphFile::Format
+    std::uint64_t n;  // number of nodes
+    std::uint64_t stride;  // words per row (bits format)
+    std::uint64_t edges;  // number of directed edges (each undirected edge counts twice)
+    std::uint64_t payload;  // bytes after the header
+    std::uint64_t checksum;  // of the payload, see GraphFile::checksum()
+    std::uint32_t byte_order;  // 0x01020304 as written
+    std::uint32_t reserved;
+};
+
+static_assert(sizeof(GraphFileHeader) == 64);
+
+
+
+/**
+ * @brief binary graph file, mapped in memory. Nothing is parsed: a graph copies the matrix rows or adjacency
+ * lists out of the mapping (in one block when the format matches), so it's loaded at the speed of a memory copy
+*/
+class GraphFile {
+    public:
+        using word_t = BitMatrix::word_t;
+
+        enum class Format : std::uint32_t {
+            bits = 0,  // bit-packed adjacency matrix
+            csr = 1  // adjacency lists
+        };
+
+        static constexpr std::uint32_t version = 1;
+
+
+        /**
+        * @brief maps a graph file, checking its header, checksum and that it holds an undirected graph without
+        * self-loops (no bits past n, symmetric matrix or sorted & symmetric lists)
+        * @throws std::runtime_error if the file can't be read, isn't a graph file or is corrupted
+        */
+        explicit GraphFile(const std::string & path);
+
+
+        /**
+        * @brief number of nodes
+        */
+        std::size_t size() const { return header.n; }
+
+        Format format() const { return static_cast<Format>(header.format); }
+
+        /**
+        * @brief number of directed edges (twice the undirected ones)
+        */
+        std::size_t edge_count() const { return header.edges; }
+
+
+        /* bits format */
+
+        /**
+        * @brief number of words per row, `BitMatrix::words_for(size())`
+        */
+        std::size_t stride() const { return header.stride; }
+
+        /**
+        * @brief rows of the adjacency matrix, one after the other
+        */
+        const word_t * rows() const { return reinterpret_cast<const word_t *>(payload); }
+
+        const word_t * row(std::size_t i) const { return rows() + i * stride(); }
+
+
+        /* csr format */
+
+        std::span<const std::uint64_t> offsets() const {
+            return {reinterpret_cast<const std::uint64_t *>(payload), size() + 1};
+        }
+
+        std::span<const std::int32_t> targets() const {
+            return {reinterpret_cast<const std::int32_t *>(payload + (size() + 1) * sizeof(std::uint64_t)), edge_count()};
+        }
+
+
+        /**
+        * @brief writes a graph file with the rows of an adjacency matrix
+        * @throws std::runtime_error if the file can't be written
+        */
+        static void save(const std::string & path, const BitMatrix & matrix);
+
+        /**
+        * @brief writes a graph file with adjacency lists (`offsets` has n + 1 entries)
+        * @throws std::runtime_error if the file can't be written
+        */
+        static void save(const std::string & path, std::span<const std::size_t> offsets, std::span<const int> targets);
+
+        /**
+        * @brief checksum of a payload (FNV-1a over 64-bit words, `bytes` must be a multiple of 8)
+        */
+        static std::uint64_t checksum(const char * data, std::size_t bytes);
+
+
+    private:
+        MappedFile file;
+        GraphFileHeader header;
+        const char * payload;
+};
+
+
+
+#endif
@@ -0,0 +1,226 @@
+#include "kclist.hpp"
+#include "clique.hpp"
+#include "parallel.hpp"
+#include "counters.hpp"
+
+#include <vector>
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+
+
+
+/**
+ * @brief graph with every edge oriented from the earlier to the later node of a degeneracy order: the out-neighbors
+ * of u are `targets[offsets[u] .. offsets[u + 1])`, in order, and there are at most `degeneracy` of them
+*/
+struct DegeneracyDAG {
+    std::vector<std::size_t> offsets;
+    std::vector<int> targets;
+    std::size_t max_out = 0;
+
+    /**
+    * @param for_each_neighbor `for_each_neighbor(u, f)` calls `f(v)` for every neighbor v of u
+    */
+    template <typename F>
+    DegeneracyDAG(const std::vector<int> & order, F for_each_neighbor) : offsets(order.size() + 1, 0), targets {} {
+        const std::size_t n = order.size();
+        std::vector<int> position (n);
+        for (std::size_t i = 0; i < n; ++i) position[order[i]] = i;
+
+        for (std::size_t u = 0; u < n; ++u) {
+            const std::size_t begin = targets.size();
+            for_each_neighbor(u, [&](std::size_t v) {
+                if (position[v] > position[u]) targets.push_back(v);
+            });
+            std::sort(targets.begin() + begin, targets.end(), [&](int a, int b) { return position[a] < position[b]; });
+
+            offsets[u + 1] = targets.size();
+            max_out = std::max(max_out, targets.size() - begin);
+        }
+        P2_COUNT(bytes_allocated, offsets.size() * sizeof(std::size_t) + targets.size() * sizeof(int));
+    }
+
+    std::span<const int> out(int u) const { return {targets.data() + offsets[u], targets.data() + offsets[u + 1]}; }
+};
+
+
+
+/**
+ * @brief scratch space of a thread, to find the cliques of one root at a time
+*/
+class CliqueLister {
+    public:
+        using word_t = BitMatrix::word_t;
+
+        CliqueLister(const DegeneracyDAG & dag, int k, const clique_visitor_t * visit) :
+            dag {dag},
+            k {k},
+            visit {visit},
+            local_index(dag.offsets.size() - 1, -1),
+            nodes {},
+            stride {BitMatrix::words_for(dag.max_out)},
+            words {0},
+            local(dag.max_out * stride),
+            levels(k, std::vector<word_t>(stride)),
+            clique {},
+            sorted {}
+        {
+            P2_COUNT(bytes_allocated, local_index.size() * sizeof(int) + (local.size() + k * stride) * sizeof(word_t));
+        }
+
+        /**
+        * @brief finds the cliques whose first node is u
+        * @return number of cliques
+        */
+        std::uint64_t root(int u) {
+            nodes.assign(dag.out(u).begin(), dag.out(u).end());
+            const std::size_t d = nodes.size();
+            if (d + 1 < static_cast<std::size_t>(k)) return 0;
+            P2_COUNT(nodes_expanded, 1);
+
+            clique.assign(1, u);
+            if (k == 1) {
+                if (visit) emit();
+                return 1;
+            }
+
+            // DAG of the out-neighbors, relabeled 0 .. d - 1 (already in order, so every row only has later nodes)
+            words = BitMatrix::words_for(d);
+            for (std::size_t i = 0; i < d; ++i) local_index[nodes[i]] = i;
+            for (std::size_t i = 0; i < d; ++i) {
+                word_t * r = row(i);
+                std::fill_n(r, words, 0);
+                P2_COUNT(edges_scanned, dag.out(nodes[i]).size());
+                for (int w : dag.out(nodes[i])) {
+                    const int j = local_index[w];
+                    if (j >= 0) r[j / BitMatrix::word_bits] |= word_t {1} << (j % BitMatrix::word_bits);
+                }
+            }
+            for (int v : nodes) local_index[v] = -1;
+
+            // every out-neighbor is a candidate
+            std::fill_n(levels[0].data(), words, 0);
+            for (std::size_t i = 0; i < d; ++i) levels[0][i / BitMatrix::word_bits] |= word_t {1} << (i % BitMatrix::word_bits);
+
+            return expand(0, k - 1);
+        }
+
+
+    private:
+        const DegeneracyDAG & dag;
+        const int k;
+        const clique_visitor_t * visit;  // nullptr = only count
+
+        std::vector<int> local_index;  // of every node in `nodes` (-1 if not there)
+        std::vector<int> nodes;  // out-neighbors of the root
+        std::size_t stride;
+        std::size_t words;  // in use by the current root
+        std::vector<word_t> local;  // DAG of `nodes`, `stride` words per row
+        std::vector<std::vector<word_t>> levels;  // candidates of every depth
+
+        std::vector<int> clique;
+        std::vector<int> sorted;
+
+        word_t * row(std::size_t i) { return local.data() + i * stride; }
+
+        void emit() {
+            sorted.assign(clique.begin(), clique.end());
+            std::sort(sorted.begin(), sorted.end());
+            (*visit)(sorted);
+        }
+
+        /**
+        * @brief extends the clique with `remaining` nodes from the candidates of depth `depth`
+        */
+        std::uint64_t expand(std::size_t depth, int remaining) {
+            const word_t * candidates = levels[depth].data();
+
+            // just count the last levels: the candidates, or the edges between them
+            if (!visit && remaining == 1) return BitMatrix::count(candidates, words);
+            if (!visit && remaining == 2) {
+                std::uint64_t total = 0;
+                for_each_bit(candidates, words, [&](std::size_t i) { total += BitMatrix::count_and(candidates, row(i), words); });
+                return total;
+            }
+
+            std::uint64_t total = 0;
+            for_each_bit(candidates, words, [&](std::size_t i) {
+                clique.push_back(nodes[i]);
+
+                if (remaining == 1) {
+                    emit();
+                    ++total;
+                }
+                else {
+                    word_t * next = levels[depth + 1].data();
+                    for (std::size_t w = 0; w < words; ++w) next[w] = candidates[w] & row(i)[w];
+
+                    if (BitMatrix::count(next, words) + 1 < static_cast<std::size_t>(remaining)) P2_COUNT(pruned, 1);
+                    else total += expand(depth + 1, remaining - 1);
+                }
+
+                clique.pop_back();
+            });
+            return total;
+        }
+};
+
+
+
+/**
+ * @brief counts (or lists) the k-cliques of the DAG, spreading the roots over `threads` threads
+*/
+static std::uint64_t cliques(const DegeneracyDAG & dag, int k, const clique_visitor_t * visit, unsigned threads) {
+    const std::size_t n = dag.offsets.size() - 1;
+    if (k <= 0 || n == 0) return 0;
+    if (threads == 0) threads = default_threads();
+
+    // roots are dealt round-robin to the chunks (a chunk per task, with its own scratch space), so costly roots are spread out
+    const std::size_t chunks = threads == 1 ? 1 : std::min<std::size_t>(n, 16 * threads);
+
+    std::atomic<std::uint64_t> total {0};
+    Counters & caller = counters;
+    std::mutex counters_lock;
+    parallel_for(0, chunks, [&](std::size_t c) {
+        count_for(caller, counters_lock, [&]() {
+            CliqueLister lister {dag, k, visit};
+            std::uint64_t found = 0;
+            for (std::size_t u = c; u < n; u += chunks) found += lister.root(u);
+            total += found;
+        });
+    }, threads);
+
+    return total;
+}
+
+
+static DegeneracyDAG orient(const BitMatrix & adjacency) {
+    return {degeneracy_order(adjacency), [&](std::size_t u, auto f) { for_each_bit(adjacency.row(u), adjacency.stride(), f); }};
+}
+
+
+static DegeneracyDAG orient(const CSRGraph & graph) {
+    return {degeneracy_order(graph), [&](std::size_t u, auto f) { for (int v : graph.neighbors(u)) f(v); }};
+}
+
+
+
+std::uint64_t count_cliques(const BitMatrix & adjacency, int k, unsigned threads) {
+    return cliques(orient(adjacency), k, nullptr, threads);
+}
+
+
+std::uint64_t count_cliques(const CSRGraph & graph, int k, unsigned threads) {
+    return cliques(orient(graph), k, nullptr, threads);
+}
+
+
+std::uint64_t list_cliques(const BitMatrix & adjacency, int k, const clique_visitor_t & visit, unsigned threads) {
+    return cliques(orient(adjacency), k, &visit, threads);
+}
+
+
+std::uint64_t list_cliques(const CSRGraph & graph, int k, const clique_visitor_t & visit, unsigned threads) {
+    return cliques(orient(graph), k, &visit, threads);
+}
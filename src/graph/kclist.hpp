@@ -0,0 +1,46 @@
+#ifndef KCLIST_HPP
+#define KCLIST_HPP
+
+
+#include <span>
+#include <functional>
+#include <cstdint>
+
+#include "bitmatrix.hpp"
+#include "csr.hpp"
+
+
+
+/**
+ * @brief called with the nodes of every clique listed, sorted. With more than 1 thread, it's called from all of them
+ * at once, so it must do its own locking
+*/
+using clique_visitor_t = std::function<void(std::span<const int>)>;
+
+
+/**
+ * @brief counts the cliques of k nodes using kClist (Danisch, Balalau & Sozio)
+ *
+ * The edges are oriented along a degeneracy order, so every clique is found once, from its first node (the root),
+ * and a root has at most `degeneracy` out-neighbors. Their subgraph is copied into a small local bit matrix, and
+ * the cliques are built by intersecting candidate bitsets with its rows. The last two levels are counted with
+ * popcounts instead of being enumerated. Roots are spread over `threads` threads (0 = one per core).
+ * Cost: O(k m (d / 2)^(k - 2)) time, with d the degeneracy, and O(n + d^2) memory per thread
+*/
+std::uint64_t count_cliques(const BitMatrix & adjacency, int k, unsigned threads = 1);
+
+std::uint64_t count_cliques(const CSRGraph & graph, int k, unsigned threads = 1);
+
+
+/**
+ * @brief lists the cliques of k nodes like count_cliques, passing each one to `visit` as soon as it's found
+ * (none are kept)
+ * @return number of cliques
+*/
+std::uint64_t list_cliques(const BitMatrix & adjacency, int k, const clique_visitor_t & visit, unsigned threads = 1);
+
+std::uint64_t list_cliques(const CSRGraph & graph, int k, const clique_visitor_t & visit, unsigned threads = 1);
+
+
+
+#endif
@@ -0,0 +1,247 @@
+#ifndef MSBFS_HPP
+#define MSBFS_HPP
+
+
+#include <vector>
+#include <array>
+#include <span>
+#include <utility>
+#include <numeric>
+#include <algorithm>
+#include <cstddef>
+#include <cassert>
+
+#include "bitmatrix.hpp"
+#include "traversal.hpp"
+#include "counters.hpp"
+
+
+
+/**
+ * @brief nodes reached from a list of sources: row i is the bit set of the nodes reached from source i
+*/
+class ReachableSets {
+    public:
+        using word_t = BitMatrix::word_t;
+
+        ReachableSets(std::size_t sources, std::size_t n) : sources {sources}, n {n}, row_stride {BitMatrix::words_for(n)}, bits(sources * row_stride, 0) { }
+
+        /**
+        * @brief number of sources (rows)
+        */
+        std::size_t size() const { return sources; }
+
+        /**
+        * @brief number of nodes of the graph (bits per row)
+        */
+        std::size_t nodes() const { return n; }
+
+        std::size_t stride() const { return row_stride; }
+
+        /**
+        * @brief checks if there is a path from source i to v
+        */
+        bool reachable(std::size_t i, std::size_t v) const { return (row(i)[v / BitMatrix::word_bits] >> (v % BitMatrix::word_bits)) & 1; }
+
+        word_t * row(std::size_t i) { return bits.data() + i * row_stride; }
+
+        const word_t * row(std::size_t i) const { return bits.data() + i * row_stride; }
+
+
+    private:
+        std::size_t sources;
+        std::size_t n;
+        std::size_t row_stride;
+        std::vector<word_t> bits;
+};
+
+
+
+/**
+ * @brief batched PATH engine: multi-source BFS (MS-BFS)
+ *
+ * Runs the BFS of up to `lanes` sources at once. Every node keeps a block of `Words` words with a bit per source
+ * (seen, visiting in this level, reached in the next one), so the adjacency of a node is scanned once per level
+ * for all the sources that reach it in that level, with one OR of the whole block per edge (a single AVX2 register
+ * for the default 256 lanes). Like Traversal, the scratch space is reused between batches.
+ * Cost: O(levels * (n + edges) * Words) per batch, instead of O(n + edges) for each of the `lanes` sources.
+*/
+template <std::size_t Words = 4>
+class MultiSourceBFS {
+    public:
+        using word_t = BitMatrix::word_t;
+        using lanes_t = std::array<word_t, Words>;  // bit i = source i of the batch
+
+        static constexpr std::size_t lanes = Words * BitMatrix::word_bits;
+
+        /**
+        * @brief runs the BFS of a batch of at most `lanes` sources. Then, `reached(v)` has the bit of every source that
+        * reaches v (every source reaches itself)
+        */
+        template <typename G>
+        void run(const G & g, std::span<const int> sources);
+
+        const lanes_t & reached(int v) const { return seen[v]; }
+
+        bool reaches(std::size_t lane, int v) const { return (seen[v][lane / BitMatrix::word_bits] >> (lane % BitMatrix::word_bits)) & 1; }
+
+
+        /**
+        * @brief PATH(u, v) for every (u, v) in `queries`: the queries are grouped by source, `lanes` sources per batch
+        */
+        template <typename G>
+        std::vector<bool> path_many(const G & g, std::span<const std::pair<int, int>> queries);
+
+        /**
+        * @brief nodes reachable from every source, `lanes` sources per batch
+        */
+        template <typename G>
+        ReachableSets reachable_from(const G & g, std::span<const int> sources);
+
+
+    private:
+        std::vector<lanes_t> seen;  // sources that reached each node
+        std::vector<lanes_t> visit;  // sources that reached each node in the current level
+        std::vector<lanes_t> next;  // sources that reach each node through the current level (including seen ones)
+        std::vector<int> frontier;  // nodes with a non-empty `visit`
+        std::vector<int> touched;  // nodes with a non-empty `next`
+
+        static bool empty(const lanes_t & l) {
+            word_t any = 0;
+            for (std::size_t k = 0; k < Words; ++k) any |= l[k];
+            return any == 0;
+        }
+};
+
+
+
+template <std::size_t Words>
+template <typename G>
+void MultiSourceBFS<Words>::run(const G & g, std::span<const int> sources) {
+    assert(sources.size() <= lanes);
+    const std::size_t n = g.size();
+
+    seen.assign(n, lanes_t {});
+    visit.assign(n, lanes_t {});
+    next.assign(n, lanes_t {});
+    frontier.clear();
+
+    for (std::size_t i = 0; i < sources.size(); ++i) {
+        const int s = sources[i];
+        assert(static_cast<std::size_t>(s) < n);
+        if (empty(visit[s])) frontier.push_back(s);
+        visit[s][i / BitMatrix::word_bits] |= word_t {1} << (i % BitMatrix::word_bits);
+        seen[s][i / BitMatrix::word_bits] |= word_t {1} << (i % BitMatrix::word_bits);
+    }
+
+    while (!frontier.empty()) {
+        // the sources visiting each frontier node go on to its neighbors, a whole block per edge
+        touched.clear();
+        for (int v : frontier) {
+            P2_COUNT(nodes_expanded, 1);
+            const lanes_t from = visit[v];
+
+            auto spread = [&](std::size_t w) {
+                lanes_t & to = next[w];
+                if (empty(to)) touched.push_back(w);
+                for (std::size_t k = 0; k < Words; ++k) to[k] |= from[k];
+            };
+
+            if constexpr (BitsetGraph<G>) {
+                const BitMatrix & adj = g.adjacency();
+                P2_COUNT(edges_scanned, adj.count(v));
+                for_each_bit(adj.row(v), adj.stride(), spread);
+            }
+            else {
+                P2_COUNT(edges_scanned, g.neighbors(v).size());
+                for (int w : g.neighbors(v)) spread(w);
+            }
+            visit[v] = lanes_t {};
+        }
+
+        // next level: the nodes reached by sources that hadn't reached them yet
+        frontier.clear();
+        for (int w : touched) {
+            lanes_t fresh;
+            for (std::size_t k = 0; k < Words; ++k) {
+                fresh[k] = next[w][k] & ~seen[w][k];
+                seen[w][k] |= fresh[k];
+            }
+            next[w] = lanes_t {};
+
+            if (!empty(fresh)) {
+                visit[w] = fresh;
+                frontier.push_back(w);
+            }
+        }
+    }
+}
+
+
+template <std::size_t Words>
+template <typename G>
+std::vector<bool> MultiSourceBFS<Words>::path_many(const G & g, std::span<const std::pair<int, int>> queries) {
+    std::vector<bool> result (queries.size(), false);
+
+    // queries by source
+    std::vector<std::size_t> order (queries.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(), [&](std::size_t a, std::size_t b) { return queries[a].first < queries[b].first; });
+
+    std::vector<int> batch {};
+    for (std::size_t begin = 0; begin < order.size();) {
+        // the queries of the next `lanes` sources
+        batch.clear();
+        std::size_t end = begin;
+        for (; end < order.size(); ++end) {
+            const int u = queries[order[end]].first;
+            if (!batch.empty() && batch.back() == u) continue;
+            if (batch.size() == lanes) break;
+            batch.push_back(u);
+        }
+
+        run(g, batch);
+
+        for (std::size_t i = begin, lane = 0; i < end; ++i) {
+            const auto [u, v] = queries[order[i]];
+            if (u != batch[lane]) ++lane;
+            assert(static_cast<std::size_t>(v) < g.size());
+            result[order[i]] = reaches(lane, v);
+        }
+        begin = end;
+    }
+
+    return result;
+}
+
+
+template <std::size_t Words>
+template <typename G>
+ReachableSets MultiSourceBFS<Words>::reachable_from(const G & g, std::span<const int> sources) {
+    const std::size_t n = g.size();
+    ReachableSets result {sources.size(), n};
+
+    for (std::size_t begin = 0; begin < sources.size(); begin += lanes) {
+        const std::size_t count = std::min(lanes, sources.size() - begin);
+        run(g, sources.subspan(begin, count));
+
+        // transpose, 64 nodes x 64 lanes at a time: the lanes of node v become bit v of the rows of their sources
+        std::array<word_t, 64> tile;
+        for (std::size_t v0 = 0; v0 < n; v0 += BitMatrix::word_bits) {
+            for (std::size_t k = 0; k * BitMatrix::word_bits < count; ++k) {
+                for (std::size_t i = 0; i < 64; ++i) tile[i] = v0 + i < n ? seen[v0 + i][k] : 0;
+                transpose(tile);
+
+                for (std::size_t l = 0; l < 64 && k * BitMatrix::word_bits + l < count; ++l) {
+                    result.row(begin + k * BitMatrix::word_bits + l)[v0 / BitMatrix::word_bits] = tile[l];
+                }
+            }
+        }
+    }
+
+    return result;
+}
+
+
+
+#endif
@@ -0,0 +1,251 @@
+#include "mst.hpp"
+#include "components.hpp"
+#include "parallel.hpp"
+#include "counters.hpp"
+
+#include <algorithm>
+#include <tuple>
+#include <limits>
+#include <mutex>
+
+
+
+/**
+ * @brief edge order of the spanning forests, by (length, u, v) with u < v
+*/
+static bool lighter(const WeightedEdge & a, const WeightedEdge & b) {
+    return std::tie(a.w, a.u, a.v) < std::tie(b.w, b.u, b.v);
+}
+
+
+static WeightedEdge edge(int u, int v, int w) {
+    return u < v ? WeightedEdge {u, v, w} : WeightedEdge {v, u, w};
+}
+
+
+static SpanningForest forest(std::vector<WeightedEdge> edges) {
+    std::sort(edges.begin(), edges.end(), [](auto & a, auto & b) { return std::tie(a.u, a.v) < std::tie(b.u, b.v); });
+
+    SpanningForest result {};
+    for (auto & e : edges) result.weight += e.w;
+    result.edges = std::move(edges);
+    return result;
+}
+
+
+
+/* KRUSKAL */
+
+
+SpanningForest kruskal(const WeightedGraph & graph) {
+    assert(!graph.directed());
+    const std::size_t n = graph.size();
+
+    // every edge once
+    std::vector<WeightedEdge> edges {};
+    edges.reserve(graph.edge_count() / 2);
+    for (std::size_t u = 0; u < n; ++u) {
+        auto adj = graph.neighbors(u);
+        auto len = graph.lengths(u);
+        for (std::size_t i = 0; i < adj.size(); ++i) {
+            if (static_cast<int>(u) < adj[i]) edges.push_back({static_cast<int>(u), adj[i], len[i]});
+        }
+    }
+    std::sort(edges.begin(), edges.end(), lighter);
+    P2_COUNT(bytes_allocated, edges.capacity() * sizeof(WeightedEdge));
+
+    DisjointSets components (n);
+    std::vector<WeightedEdge> tree {};
+    for (auto & e : edges) {
+        P2_COUNT(edges_scanned, 1);
+        if (components.unite(e.u, e.v)) tree.push_back(e);
+        if (components.count() == 1) break;  // spanning tree complete
+    }
+
+    return forest(std::move(tree));
+}
+
+
+
+/* PRIM */
+
+
+/**
+ * @brief binary min-heap of nodes, keyed by their shortest edge to the tree, with the position of every node so
+ * its key can be decreased in place
+*/
+class IndexedHeap {
+    public:
+        explicit IndexedHeap(std::size_t n) : heap {}, position(n, absent), key(n) { }
+
+        bool empty() const { return heap.empty(); }
+
+        bool contains(int v) const { return position[v] != absent; }
+
+        const WeightedEdge & edge(int v) const { return key[v]; }
+
+        /**
+        * @brief adds v with an edge, or replaces its edge if the new one is lighter
+        */
+        void push_or_decrease(int v, const WeightedEdge & e) {
+            if (!contains(v)) {
+                key[v] = e;
+                position[v] = heap.size();
+                heap.push_back(v);
+            }
+            else if (lighter(e, key[v])) key[v] = e;
+            else return;
+            sift_up(position[v]);
+        }
+
+        /**
+        * @brief removes the node with the lightest edge
+        */
+        int pop() {
+            const int top = heap.front();
+            position[top] = absent;
+            heap.front() = heap.back();
+            heap.pop_back();
+            if (!heap.empty()) {
+                position[heap.front()] = 0;
+                sift_down(0);
+            }
+            return top;
+        }
+
+
+    private:
+        static constexpr std::size_t absent = std::numeric_limits<std::size_t>::max();
+
+        std::vector<int> heap;
+        std::vector<std::size_t> position;  // of every node in heap (absent if not there)
+        std::vector<WeightedEdge> key;
+
+        void place(std::size_t i, int v) {
+            heap[i] = v;
+            position[v] = i;
+        }
+
+        void sift_up(std::size_t i) {
+            const int v = heap[i];
+            while (i > 0 && lighter(key[v], key[heap[(i - 1) / 2]])) {
+                place(i, heap[(i - 1) / 2]);
+                i = (i - 1) / 2;
+            }
+            place(i, v);
+        }
+
+        void sift_down(std::size_t i) {
+            const int v = heap[i];
+            for (std::size_t child = 2 * i + 1; child < heap.size(); child = 2 * i + 1) {
+                if (child + 1 < heap.size() && lighter(key[heap[child + 1]], key[heap[child]])) ++child;
+                if (!lighter(key[heap[child]], key[v])) break;
+                place(i, heap[child]);
+                i = child;
+            }
+            place(i, v);
+        }
+};
+
+
+SpanningForest prim(const WeightedGraph & graph) {
+    assert(!graph.directed());
+    const std::size_t n = graph.size();
+
+    IndexedHeap heap (n);
+    std::vector<bool> in_tree (n, false);
+    std::vector<WeightedEdge> tree {};
+    P2_COUNT(bytes_allocated, n * (sizeof(int) + sizeof(std::size_t) + sizeof(WeightedEdge)));
+
+    auto add = [&](int u) {
+        in_tree[u] = true;
+        P2_COUNT(nodes_expanded, 1);
+
+        auto adj = graph.neighbors(u);
+        auto len = graph.lengths(u);
+        P2_COUNT(edges_scanned, adj.size());
+        for (std::size_t i = 0; i < adj.size(); ++i) {
+            if (!in_tree[adj[i]]) heap.push_or_decrease(adj[i], edge(u, adj[i], len[i]));
+        }
+    };
+
+    // a tree per component
+    for (std::size_t root = 0; root < n; ++root) {
+        if (in_tree[root]) continue;
+
+        add(root);
+        while (!heap.empty()) {
+            const int v = heap.pop();
+            tree.push_back(heap.edge(v));
+            add(v);
+        }
+    }
+
+    return forest(std::move(tree));
+}
+
+
+
+/* BORŮVKA */
+
+
+SpanningForest boruvka(const WeightedGraph & graph, unsigned threads) {
+    assert(!graph.directed());
+    const std::size_t n = graph.size();
+    constexpr WeightedEdge none {-1, -1, 0};  // no edge out
+
+    DisjointSets components (n);
+    std::vector<int> label (n);  // component of every node in this round
+    for (std::size_t v = 0; v < n; ++v) label[v] = v;
+
+    std::vector<WeightedEdge> shortest (n);  // shortest edge out of the component of every node
+    std::vector<WeightedEdge> best (n);  // shortest edge out of every component (by label)
+    std::vector<WeightedEdge> tree {};
+    P2_COUNT(bytes_allocated, n * (sizeof(int) + 2 * sizeof(WeightedEdge)));
+
+    Counters & caller = counters;
+    std::mutex counters_lock;
+
+    for (bool merged = true; merged;) {
+        // the shortest edge out of every node's component, in parallel (only reads the labels)
+        constexpr std::size_t nodes_per_chunk = 1024;
+        parallel_for(0, (n + nodes_per_chunk - 1) / nodes_per_chunk, [&](std::size_t c) {
+            count_for(caller, counters_lock, [&]() {
+                for (std::size_t u = c * nodes_per_chunk; u < std::min(n, (c + 1) * nodes_per_chunk); ++u) {
+                    WeightedEdge min = none;
+                    P2_COUNT(nodes_expanded, 1);
+                    auto adj = graph.neighbors(u);
+                    auto len = graph.lengths(u);
+                    P2_COUNT(edges_scanned, adj.size());
+                    for (std::size_t i = 0; i < adj.size(); ++i) {
+                        if (label[adj[i]] == label[u]) continue;
+                        const WeightedEdge e = edge(u, adj[i], len[i]);
+                        if (min.u < 0 || lighter(e, min)) min = e;
+                    }
+                    shortest[u] = min;
+                }
+            });
+        }, threads);
+
+        // shortest edge out of every component
+        std::fill(best.begin(), best.end(), none);
+        for (std::size_t u = 0; u < n; ++u) {
+            auto & b = best[label[u]];
+            if (shortest[u].u >= 0 && (b.u < 0 || lighter(shortest[u], b))) b = shortest[u];
+        }
+
+        // add them (an edge can be chosen by its two components: the second one closes no new union)
+        merged = false;
+        for (std::size_t c = 0; c < n; ++c) {
+            if (best[c].u < 0) continue;
+            if (components.unite(best[c].u, best[c].v)) {
+                tree.push_back(best[c]);
+                merged = true;
+            }
+        }
+
+        for (std::size_t v = 0; v < n; ++v) label[v] = components.find(v);
+    }
+
+    return forest(std::move(tree));
+}
@@ -0,0 +1,51 @@
+#ifndef MST_HPP
+#define MST_HPP
+
+
+#include <vector>
+#include <cstdint>
+
+#include "weighted.hpp"
+
+
+
+/**
+ * @brief minimum spanning forest: a minimum spanning tree of every connected component
+*/
+struct SpanningForest {
+    std::int64_t weight = 0;  // total length of the edges
+    std::vector<WeightedEdge> edges;  // with u < v, sorted by (u, v)
+};
+
+
+/*
+ * Edges are compared by (length, u, v), so the spanning forest is unique and every algorithm returns
+ * the same one. They only take undirected graphs.
+*/
+
+
+/**
+ * @brief minimum spanning forest using Kruskal: the edges by increasing length, skipping the ones that would
+ * close a cycle (DisjointSets). O(edges log edges)
+*/
+SpanningForest kruskal(const WeightedGraph & graph);
+
+
+/**
+ * @brief minimum spanning forest using Prim: grows a tree from every node not reached yet, taking the shortest
+ * edge out of it from an indexed binary heap (one entry per node, its shortest edge to the tree, decreased in place).
+ * O(edges log n), and O(n) memory besides the result
+*/
+SpanningForest prim(const WeightedGraph & graph);
+
+
+/**
+ * @brief minimum spanning forest using Borůvka: in every round each component takes its shortest edge out,
+ * which at least halves the components. The edges are scanned on `threads` threads (0 = one per core),
+ * so a round costs O(edges / threads + n), and there are O(log n) rounds
+*/
+SpanningForest boruvka(const WeightedGraph & graph, unsigned threads = 0);
+
+
+
+#endif
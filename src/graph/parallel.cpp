@@ -0,0 +1,113 @@
+#include "parallel.hpp"
+
+
+
+// worker running the calling thread, and the pool it belongs to (a task may submit to another pool)
+static thread_local const TaskPool * current_pool = nullptr;
+static thread_local int current_worker = -1;
+
+
+
+TaskPool::TaskPool(unsigned threads) :
+    queues {},
+    workers {},
+    queued {0},
+    pending {0},
+    next_queue {0},
+    stopping {false}
+{
+    if (threads == 0) threads = default_threads();
+
+    for (unsigned t = 0; t < threads; ++t) queues.push_back(std::make_unique<Queue>());
+    for (unsigned t = 0; t < threads; ++t) workers.emplace_back(&TaskPool::work, this, t);
+}
+
+
+TaskPool::~TaskPool() {
+    wait();
+    {
+        std::lock_guard<std::mutex> guard {state_lock};
+        stopping = true;
+    }
+    work_available.notify_all();
+    workers.clear();  // join them while the rest of the pool is still alive
+}
+
+
+int TaskPool::worker_index() {
+    return current_worker;
+}
+
+
+void TaskPool::submit(task_t task) {
+    const unsigned q = (current_pool == this) ? current_worker : next_queue++ % size();
+
+    pending++;
+    queued++;
+    {
+        std::lock_guard<std::mutex> guard {queues[q]->lock};
+        queues[q]->tasks.push_back(std::move(task));
+    }
+
+    {
+        std::lock_guard<std::mutex> guard {state_lock};  // a worker can't miss the notification while deciding to sleep
+    }
+    work_available.notify_one();
+}
+
+
+void TaskPool::wait() {
+    std::unique_lock<std::mutex> guard {state_lock};
+    all_done.wait(guard, [this]() { return pending == 0; });
+}
+
+
+bool TaskPool::take(unsigned self, task_t & task) {
+    {
+        Queue & own = *queues[self];
+        std::lock_guard<std::mutex> guard {own.lock};
+        if (!own.tasks.empty()) {
+            task = std::move(own.tasks.front());
+            own.tasks.pop_front();
+            queued--;
+            return true;
+        }
+    }
+
+    for (unsigned i = 1; i < size(); ++i) {
+        Queue & victim = *queues[(self + i) % size()];
+        std::lock_guard<std::mutex> guard {victim.lock};
+        if (!victim.tasks.empty()) {
+            task = std::move(victim.tasks.back());
+            victim.tasks.pop_back();
+            queued--;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+
+void TaskPool::work(unsigned self) {
+    current_pool = this;
+    current_worker = self;
+    task_t task;
+
+    while (true) {
+        if (take(self, task)) {
+            task();
+            task = nullptr;
+
+            if (--pending == 0) {
+                std::lock_guard<std::mutex> guard {state_lock};
+                all_done.notify_all();
+            }
+            continue;
+        }
+
+        std::unique_lock<std::mutex> guard {state_lock};
+        work_available.wait(guard, [this]() { return stopping || queued > 0; });
+        if (stopping && queued == 0) return;
+    }
+}
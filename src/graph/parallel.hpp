@@ -0,0 +1,129 @@
+#ifndef PARALLEL_HPP
+#define PARALLEL_HPP
+
+
+#include <cstddef>
+#include <thread>
+#include <atomic>
+#include <vector>
+#include <algorithm>
+#include <functional>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <condition_variable>
+
+
+
+/**
+ * @brief number of threads to use when the caller asks for 0 (one per core)
+*/
+inline unsigned default_threads() {
+    return std::max(1u, std::thread::hardware_concurrency());
+}
+
+
+/**
+ * @brief calls `f(i)` for every i in [begin, end) using up to `threads` threads (0 = one per core).
+ * Indices are handed out one at a time, so uneven iterations are balanced. Blocks until all are done
+*/
+template <typename F>
+void parallel_for(std::size_t begin, std::size_t end, F f, unsigned threads = 0) {
+    if (begin >= end) return;
+    if (threads == 0) threads = default_threads();
+    threads = static_cast<unsigned>(std::min<std::size_t>(threads, end - begin));
+
+    if (threads <= 1) {  // not worth starting threads
+        for (std::size_t i = begin; i < end; ++i) f(i);
+        return;
+    }
+
+    std::atomic<std::size_t> next {begin};
+    auto worker = [&]() {
+        for (std::size_t i = next++; i < end; i = next++) f(i);
+    };
+
+    std::vector<std::jthread> pool {};
+    pool.reserve(threads - 1);
+    for (unsigned t = 1; t < threads; ++t) pool.emplace_back(worker);
+    worker();  // the calling thread works too
+}
+
+
+
+
+/**
+ * @brief fixed set of worker threads running tasks with work stealing
+ *
+ * Every worker has its own queue. Tasks submitted from outside the pool (including from the workers of another
+ * pool) are dealt round-robin; tasks submitted by a task go to its worker's queue. A worker takes tasks from the front of its queue,
+ * and when it runs out, steals from the back of the others'
+*/
+class TaskPool {
+    public:
+        using task_t = std::function<void()>;
+
+        /**
+        * @brief starts `threads` workers (0 = one per core)
+        */
+        explicit TaskPool(unsigned threads = 0);
+
+        /**
+        * @brief waits for the pending tasks and stops the workers
+        */
+        ~TaskPool();
+
+        TaskPool(const TaskPool &) = delete;
+        TaskPool & operator = (const TaskPool &) = delete;
+
+
+        /**
+        * @brief number of workers
+        */
+        unsigned size() const { return static_cast<unsigned>(workers.size()); }
+
+        /**
+        * @brief queues a task
+        */
+        void submit(task_t task);
+
+        /**
+        * @brief blocks until every submitted task has finished
+        */
+        void wait();
+
+        /**
+        * @brief index of the worker running the calling thread, in [0, size()) of the pool it belongs to. -1 outside of a pool
+        */
+        static int worker_index();
+
+
+    private:
+        struct Queue {
+            std::mutex lock;
+            std::deque<task_t> tasks;
+        };
+
+        std::vector<std::unique_ptr<Queue>> queues;
+        std::vector<std::jthread> workers;
+
+        std::atomic<std::size_t> queued;  // tasks waiting in a queue
+        std::atomic<std::size_t> pending;  // tasks submitted but not finished
+        std::atomic<unsigned> next_queue;  // round-robin for outside submissions
+
+        std::mutex state_lock;
+        std::condition_variable work_available;
+        std::condition_variable all_done;
+        bool stopping;
+
+        /**
+        * @brief takes a task from the front of the worker's queue, or steals one from the back of another
+        */
+        bool take(unsigned self, task_t & task);
+
+        void work(unsigned self);
+};
+
+
+
+#endif
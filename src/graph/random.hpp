@@ -0,0 +1,78 @@
+#ifndef RANDOM_HPP
+#define RANDOM_HPP
+
+
+#include <cstdint>
+#include <array>
+
+
+
+/**
+ * @brief Philox4x32-10 counter-based generator (Salmon et al., "Parallel random numbers: as easy as 1, 2, 3")
+ *
+ * The random block of a 128-bit counter is a keyed bijection of it, with no state in between: any part of
+ * a random stream can be computed on its own, in any order and on any thread, with the same result.
+*/
+class Philox {
+    public:
+        using block_t = std::array<std::uint32_t, 4>;
+
+        explicit constexpr Philox(std::uint64_t key) : key {static_cast<std::uint32_t>(key), static_cast<std::uint32_t>(key >> 32)} { }
+
+        /**
+        * @brief random block of a counter
+        */
+        constexpr block_t operator () (block_t counter) const {
+            std::array<std::uint32_t, 2> k = key;
+            for (int round = 0; round < 10; ++round) {
+                const std::uint64_t p0 = std::uint64_t {0xD2511F53} * counter[0];
+                const std::uint64_t p1 = std::uint64_t {0xCD9E8D57} * counter[2];
+                counter = {
+                    static_cast<std::uint32_t>(p1 >> 32) ^ counter[1] ^ k[0],
+                    static_cast<std::uint32_t>(p1),
+                    static_cast<std::uint32_t>(p0 >> 32) ^ counter[3] ^ k[1],
+                    static_cast<std::uint32_t>(p0)
+                };
+                k[0] += 0x9E3779B9;
+                k[1] += 0xBB67AE85;
+            }
+            return counter;
+        }
+
+        /**
+        * @brief the random block of a counter as 2 64-bit words
+        */
+        constexpr std::array<std::uint64_t, 2> words(block_t counter) const {
+            const block_t r = (*this)(counter);
+            return {r[0] | std::uint64_t {r[1]} << 32, r[2] | std::uint64_t {r[3]} << 32};
+        }
+
+
+    private:
+        std::array<std::uint32_t, 2> key;
+};
+
+
+
+/**
+ * @brief uniform number in [0, 1) from a random word (its 53 high bits)
+*/
+constexpr double unit(std::uint64_t word) {
+    return (word >> 11) * 0x1p-53;
+}
+
+
+/**
+ * @brief seed of the `stream`-th graph of a run with `seed` (SplitMix64 of both), so the graphs of the
+ * iterations and of a sweep are independent but each can be reproduced on its own
+*/
+constexpr std::uint64_t stream_seed(std::uint64_t seed, std::uint64_t stream) {
+    std::uint64_t z = seed + (stream + 1) * 0x9E3779B97F4A7C15;
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EB;
+    return z ^ (z >> 31);
+}
+
+
+
+#endif
@@ -0,0 +1,125 @@
+#include "satgraph.hpp"
+#include "clique.hpp"
+#include "counters.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+
+
+
+/**
+ * @brief calls f(k, mask) for every word k overlapping the bits [begin, end), with the mask of its bits in the range
+*/
+template <typename F>
+static void for_each_word(std::size_t begin, std::size_t end, F f) {
+    using word_t = BitMatrix::word_t;
+    constexpr std::size_t bits = BitMatrix::word_bits;
+    if (begin >= end) return;
+
+    const std::size_t first = begin / bits;
+    const std::size_t last = (end - 1) / bits;
+    for (std::size_t k = first; k <= last; ++k) {
+        word_t mask = ~word_t {0};
+        if (k == first) mask &= ~word_t {0} << (begin % bits);
+        if (k == last) mask &= ~word_t {0} >> (bits - 1 - (end - 1) % bits);
+        f(k, mask);
+    }
+}
+
+
+static bool test(const BitMatrix::word_t * set, std::size_t u) {
+    return (set[u / BitMatrix::word_bits] >> (u % BitMatrix::word_bits)) & 1;
+}
+
+
+
+SatGraph::SatGraph(const CNF & cnf) :
+    cnf {cnf},
+    n_words {BitMatrix::words_for(cnf.literals.size())},
+    clause (cnf.literals.size()),
+    first {},
+    nodes (cnf.literals.size())
+{
+    std::size_t variables = cnf.variables();
+    for (auto & x : cnf.literals) variables = std::max<std::size_t>(variables, std::abs(x));
+
+    for (std::size_t c = 0; c < cnf.size(); ++c) {
+        std::fill(clause.begin() + cnf.offsets[c], clause.begin() + cnf.offsets[c + 1], c);
+    }
+
+    // nodes grouped by literal (counting sort)
+    first.assign(2 * variables + 1, 0);
+    for (auto & x : cnf.literals) ++first[index(x) + 1];
+    for (std::size_t l = 0; l < 2 * variables; ++l) first[l + 1] += first[l];
+
+    std::vector<std::size_t> next (first.begin(), first.end() - 1);
+    for (std::size_t v = 0; v < cnf.literals.size(); ++v) nodes[next[index(cnf.literals[v])]++] = v;
+
+    P2_COUNT(bytes_allocated, clause.size() * sizeof(std::uint32_t) + first.size() * sizeof(std::size_t) + nodes.size() * sizeof(int));
+}
+
+
+
+std::size_t SatGraph::count(std::size_t v) const {
+    const std::size_t c = clause[v];
+    std::size_t d = size() - (cnf.offsets[c + 1] - cnf.offsets[c]);
+    for_each_complement(v, [&](std::size_t) { --d; });
+    return d;
+}
+
+
+void SatGraph::copy_row(std::size_t v, word_t * out) const {
+    std::fill_n(out, n_words, 0);
+    for_each_word(0, size(), [&](std::size_t k, word_t mask) { out[k] = mask; });
+
+    const std::size_t c = clause[v];
+    for_each_word(cnf.offsets[c], cnf.offsets[c + 1], [&](std::size_t k, word_t mask) { out[k] &= ~mask; });
+    for_each_complement(v, [&](std::size_t u) { out[u / BitMatrix::word_bits] &= ~(word_t {1} << (u % BitMatrix::word_bits)); });
+}
+
+
+void SatGraph::intersect(std::size_t v, const word_t * set, word_t * out) const {
+    std::copy_n(set, n_words, out);
+
+    const std::size_t c = clause[v];
+    for_each_word(cnf.offsets[c], cnf.offsets[c + 1], [&](std::size_t k, word_t mask) { out[k] &= ~mask; });
+    for_each_complement(v, [&](std::size_t u) { out[u / BitMatrix::word_bits] &= ~(word_t {1} << (u % BitMatrix::word_bits)); });
+}
+
+
+void SatGraph::subtract(std::size_t v, const word_t * set, word_t * out) const {
+    std::fill_n(out, n_words, 0);
+
+    const std::size_t c = clause[v];
+    for_each_word(cnf.offsets[c], cnf.offsets[c + 1], [&](std::size_t k, word_t mask) { out[k] = set[k] & mask; });
+    for_each_complement(v, [&](std::size_t u) {
+        if (test(set, u)) out[u / BitMatrix::word_bits] |= word_t {1} << (u % BitMatrix::word_bits);
+    });
+}
+
+
+std::size_t SatGraph::count_in(std::size_t v, const word_t * set) const {
+    std::size_t d = BitMatrix::count(set, n_words);
+
+    const std::size_t c = clause[v];
+    for_each_word(cnf.offsets[c], cnf.offsets[c + 1], [&](std::size_t k, word_t mask) { d -= std::popcount(set[k] & mask); });
+    for_each_complement(v, [&](std::size_t u) { d -= test(set, u); });
+    return d;
+}
+
+
+
+std::vector<int> SatGraph::max_clique(int target, unsigned threads) const {
+    if (threads != 1) return parallel_max_clique(*this, target, threads);
+
+    CliqueSearch search {*this, target};
+    return search.run();
+}
+
+
+bool SatGraph::satisfiable(unsigned threads) const {
+    // clauses are independent sets, so a clique has at most a node per clause
+    const int k = clauses();
+    if (k == 0) return true;
+    return static_cast<int>(max_clique(k, threads).size()) >= k;
+}
@@ -0,0 +1,144 @@
+#ifndef SATGRAPH_HPP
+#define SATGRAPH_HPP
+
+
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+
+#include "bitmatrix.hpp"
+#include "cnf.hpp"
+
+
+
+/**
+ * @brief graph of the K-SAT to k-clique reduction, answered from the formula instead of stored
+ *
+ * There's a node per literal occurrence, numbered in the order of the formula, so the nodes of a clause
+ * are a range. Two nodes are connected if they're in different clauses and their literals aren't each
+ * other's negation. Besides the formula (which must outlive the graph), it only keeps the clause of every
+ * node and the nodes of every literal: building it is O(literals + variables), and a neighborhood
+ * operation is O(n / 64) plus the size of a clause and the occurrences of a literal.
+*/
+class SatGraph {
+    public:
+        using word_t = BitMatrix::word_t;
+
+        explicit SatGraph(const CNF & cnf);
+
+
+        /**
+        * @brief number of nodes (literal occurrences)
+        */
+        std::size_t size() const { return clause.size(); }
+
+        /**
+        * @brief number of words of a node set, as in BitMatrix rows
+        */
+        std::size_t stride() const { return n_words; }
+
+        /**
+        * @brief number of clauses, the size of the clique that satisfies the formula
+        */
+        std::size_t clauses() const { return cnf.size(); }
+
+        /**
+        * @brief literal of node v
+        */
+        int literal(std::size_t v) const { return cnf.literals[v]; }
+
+        bool has_edge(std::size_t u, std::size_t v) const {
+            return clause[u] != clause[v] && cnf.literals[u] != -cnf.literals[v];
+        }
+
+
+        /* neighborhood operations on node sets of `stride()` words, as in BitMatrix */
+
+        /**
+        * @brief number of neighbors of v
+        */
+        std::size_t count(std::size_t v) const;
+
+        /**
+        * @brief out = N(v)
+        */
+        void copy_row(std::size_t v, word_t * out) const;
+
+        /**
+        * @brief out = set ∩ N(v)
+        */
+        void intersect(std::size_t v, const word_t * set, word_t * out) const;
+
+        /**
+        * @brief out = set \ N(v)
+        */
+        void subtract(std::size_t v, const word_t * set, word_t * out) const;
+
+        /**
+        * @brief number of nodes of `set` in N(v)
+        */
+        std::size_t count_in(std::size_t v, const word_t * set) const;
+
+
+        /**
+        * @brief finds a clique with CliqueSearch (or parallel_max_clique with threads != 1)
+        * @param target stop as soon as a clique of `target` nodes is found (0 = find a maximum clique)
+        * @return nodes of the clique, sorted. With a target, it has fewer nodes if there is no clique of `target` nodes
+        */
+        std::vector<int> max_clique(int target = 0, unsigned threads = 1) const;
+
+        /**
+        * @brief checks if there is a clique of a node per clause, that is, if the formula is satisfiable
+        */
+        bool satisfiable(unsigned threads = 1) const;
+
+
+        /* overload << operator: adjacency matrix, as Graph */
+        friend std::ostream & operator << (std::ostream & out, const SatGraph & graph) {
+            const size_t n = graph.size();
+
+            out << "[";
+            for (size_t i = 0; i < n; ++i) {
+                out << "[";
+                for (size_t j = 0; j < n; ++j) {
+                    out << graph.has_edge(i, j);
+                    if (j < n - 1) out << ", ";
+                }
+                out << "]";
+
+                if (i < n - 1) out << ", ";
+            }
+            out << "]";
+
+            return out;
+        }
+
+
+    private:
+        const CNF & cnf;
+        std::size_t n_words;
+        std::vector<std::uint32_t> clause;  // clause of every node
+        std::vector<std::size_t> first;  // nodes of literal index l are nodes[first[l] .. first[l + 1])
+        std::vector<int> nodes;
+
+        /**
+        * @brief index of a literal in `first`: 2 (v - 1) for v, 2 (v - 1) + 1 for -v
+        */
+        static std::size_t index(int literal) { return literal > 0 ? 2 * (literal - 1) : 2 * (-literal - 1) + 1; }
+
+        /**
+        * @brief calls f(u) for every node with the negation of v's literal, outside v's clause (the rest of the non-neighbors)
+        */
+        template <typename F>
+        void for_each_complement(std::size_t v, F f) const {
+            const std::size_t l = index(-cnf.literals[v]);
+            for (std::size_t i = first[l]; i < first[l + 1]; ++i) {
+                if (clause[nodes[i]] != clause[v]) f(nodes[i]);
+            }
+        }
+};
+
+
+
+#endif
@@ -0,0 +1,151 @@
+#include "sssp.hpp"
+#include "parallel.hpp"
+#include "counters.hpp"
+
+#include <algorithm>
+
+
+
+std::pair<RadixHeap::key_t, int> RadixHeap::pop() {
+    assert(!empty());
+
+    if (buckets[0].empty()) {
+        std::size_t i = 1;
+        while (buckets[i].empty()) ++i;
+
+        // the minimum of bucket i becomes the last key: its entries now differ from it in lower bits
+        last = std::min_element(buckets[i].begin(), buckets[i].end())->first;
+        for (auto & entry : buckets[i]) buckets[bucket(entry.first)].push_back(entry);
+        buckets[i].clear();
+    }
+
+    auto entry = buckets[0].back();
+    buckets[0].pop_back();
+    --count;
+    return entry;
+}
+
+
+
+std::vector<DistanceMatrix::dist_t> dijkstra(const WeightedGraph & graph, int source) {
+    using dist_t = DistanceMatrix::dist_t;
+    assert(static_cast<std::size_t>(source) < graph.size());
+
+    std::vector<dist_t> dist (graph.size(), DistanceMatrix::infinity);
+    P2_COUNT(bytes_allocated, dist.size() * sizeof(dist_t));
+
+    RadixHeap heap {};
+    dist[source] = 0;
+    heap.push(0, source);
+
+    while (!heap.empty()) {
+        const auto [d, u] = heap.pop();
+        if (static_cast<dist_t>(d) > dist[u]) continue;  // stale entry, u was reached by a shorter path
+        P2_COUNT(nodes_expanded, 1);
+
+        auto adj = graph.neighbors(u);
+        auto len = graph.lengths(u);
+        P2_COUNT(edges_scanned, adj.size());
+        for (std::size_t i = 0; i < adj.size(); ++i) {
+            const dist_t alt = static_cast<dist_t>(d) + len[i];
+            if (alt < dist[adj[i]]) {
+                dist[adj[i]] = alt;
+                heap.push(alt, adj[i]);
+            }
+        }
+    }
+
+    return dist;
+}
+
+
+
+std::vector<DistanceMatrix::dist_t> delta_stepping(const WeightedGraph & graph, int source, unsigned threads, WeightedGraph::weight_t delta) {
+    using dist_t = DistanceMatrix::dist_t;
+    using request_t = std::pair<int, dist_t>;  // (node, distance through the edge)
+    assert(static_cast<std::size_t>(source) < graph.size());
+
+    const std::size_t n = graph.size();
+    if (threads == 0) threads = default_threads();
+    if (delta <= 0) {
+        const double degree = std::max<double>(1, static_cast<double>(graph.edge_count()) / n);
+        delta = std::max<WeightedGraph::weight_t>(1, graph.max_weight() / degree);
+    }
+
+    std::vector<dist_t> dist (n, DistanceMatrix::infinity);
+    std::vector<std::vector<int>> buckets {};  // nodes by dist / delta (with stale entries, left by later improvements)
+    std::vector<std::size_t> mark (n, 0);  // last round a node was taken in, to skip duplicates
+    std::size_t round = 0;
+    P2_COUNT(bytes_allocated, n * (sizeof(dist_t) + sizeof(std::size_t)));
+
+    auto relax = [&](int v, dist_t d) {
+        if (d >= dist[v]) return;
+        dist[v] = d;
+        const std::size_t b = d / delta;
+        if (b >= buckets.size()) buckets.resize(b + 1);
+        buckets[b].push_back(v);
+    };
+
+    // relaxations of the edges of `nodes` (light or heavy), scanned in parallel, then applied in order
+    std::vector<std::vector<request_t>> requests (4 * threads);
+    Counters & caller = counters;
+    std::mutex counters_lock;
+    auto scan = [&](const std::vector<int> & nodes, bool light) {
+        const std::size_t chunks = std::min(requests.size(), nodes.size() / 256 + 1);
+        const std::size_t chunk = (nodes.size() + chunks - 1) / chunks;
+
+        parallel_for(0, chunks, [&](std::size_t c) {
+            count_for(caller, counters_lock, [&]() {
+                requests[c].clear();
+                for (std::size_t i = c * chunk; i < std::min(nodes.size(), (c + 1) * chunk); ++i) {
+                    const int u = nodes[i];
+                    auto adj = graph.neighbors(u);
+                    auto len = graph.lengths(u);
+                    P2_COUNT(edges_scanned, adj.size());
+                    for (std::size_t e = 0; e < adj.size(); ++e) {
+                        if ((len[e] <= delta) == light && dist[u] + len[e] < dist[adj[e]]) requests[c].emplace_back(adj[e], dist[u] + len[e]);
+                    }
+                }
+            });
+        }, std::min<std::size_t>(threads, chunks));
+
+        for (std::size_t c = 0; c < chunks; ++c) {
+            for (auto & [v, d] : requests[c]) relax(v, d);
+        }
+    };
+
+    relax(source, 0);
+
+    std::vector<int> frontier {};
+    std::vector<int> settled {};
+    for (std::size_t b = 0; b < buckets.size(); ++b) {
+        settled.clear();
+
+        // light edges, until no node falls in this bucket again
+        while (!buckets[b].empty()) {
+            ++round;
+            frontier.clear();
+            for (int v : buckets[b]) {
+                if (static_cast<std::size_t>(dist[v] / delta) != b || mark[v] == round) continue;  // stale or repeated
+                mark[v] = round;
+                frontier.push_back(v);
+            }
+            buckets[b].clear();
+            P2_COUNT(nodes_expanded, frontier.size());
+
+            settled.insert(settled.end(), frontier.begin(), frontier.end());
+            scan(frontier, true);
+        }
+
+        // heavy edges once, from the final distances (they can't reach this bucket)
+        ++round;
+        std::erase_if(settled, [&](int v) {
+            if (mark[v] == round) return true;
+            mark[v] = round;
+            return false;
+        });
+        scan(settled, false);
+    }
+
+    return dist;
+}
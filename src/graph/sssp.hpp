@@ -0,0 +1,81 @@
+#ifndef SSSP_HPP
+#define SSSP_HPP
+
+
+#include <vector>
+#include <array>
+#include <utility>
+#include <cstddef>
+#include <cstdint>
+#include <cassert>
+#include <bit>
+
+#include "weighted.hpp"
+#include "apsp.hpp"
+
+
+
+/**
+ * @brief monotone priority queue of (key, node) for Dijkstra: the popped keys never decrease
+ *
+ * An entry goes to the bucket of the highest bit where its key differs from the last popped key. When
+ * bucket 0 (keys equal to the last) is empty, the first non-empty bucket is split by its minimum key,
+ * and its entries always move to lower buckets: each entry moves at most 32 times, so n pushes and pops
+ * cost O(n log C) for keys up to C, with no comparisons between entries.
+*/
+class RadixHeap {
+    public:
+        using key_t = std::uint32_t;
+
+        RadixHeap(): buckets {}, last {0}, count {0} { }
+
+        bool empty() const { return count == 0; }
+
+        std::size_t size() const { return count; }
+
+        /**
+        * @brief adds a node with a key, not smaller than the last popped one
+        */
+        void push(key_t key, int node) {
+            assert(key >= last);
+            buckets[bucket(key)].emplace_back(key, node);
+            ++count;
+        }
+
+        /**
+        * @brief removes an entry with the minimum key
+        */
+        std::pair<key_t, int> pop();
+
+
+    private:
+        std::array<std::vector<std::pair<key_t, int>>, 33> buckets;
+        key_t last;  // last key popped
+        std::size_t count;
+
+        std::size_t bucket(key_t key) const { return key == last ? 0 : 32 - std::countl_zero(key ^ last); }
+};
+
+
+
+/**
+ * @brief lengths of the shortest paths from a node to all the others (DistanceMatrix::infinity = unreachable),
+ * using Dijkstra with a RadixHeap. O(edges + n log C), with C the longest path
+*/
+std::vector<DistanceMatrix::dist_t> dijkstra(const WeightedGraph & graph, int source);
+
+
+/**
+ * @brief lengths of the shortest paths from a node to all the others, using delta-stepping (Meyer & Sanders)
+ *
+ * Nodes are kept in buckets of distances of width `delta`. The nodes of the first non-empty bucket are
+ * settled together: their light edges (length <= delta) are relaxed until the bucket stays empty, then their
+ * heavy edges once. The edges of each round are scanned on `threads` threads (0 = one per core), and the
+ * resulting relaxations applied in order, so the result doesn't depend on the threads
+ * @param delta width of the buckets (0 = the longest edge over the average degree)
+*/
+std::vector<DistanceMatrix::dist_t> delta_stepping(const WeightedGraph & graph, int source, unsigned threads = 0, WeightedGraph::weight_t delta = 0);
+
+
+
+#endif
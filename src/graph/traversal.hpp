@@ -0,0 +1,233 @@
+#ifndef TRAVERSAL_HPP
+#define TRAVERSAL_HPP
+
+
+#include <vector>
+#include <cstddef>
+#include <concepts>
+
+#include "bitmatrix.hpp"
+#include "counters.hpp"
+
+
+
+/**
+ * @brief graphs that expose their adjacency as a BitMatrix (traversals work on whole words of neighbors)
+*/
+template <typename G>
+concept BitsetGraph = requires(const G & g) {
+    { g.adjacency() } -> std::convertible_to<const BitMatrix &>;
+};
+
+
+
+/**
+ * @brief iterative PATH(u, v) engine
+ *
+ * Keeps an explicit stack/queue and a visited bit vector that are reused between queries, so
+ * after the first call a query doesn't allocate, and there is no recursion (no stack overflow on long paths).
+ * Traversals follow the out-edges (rows) of each node.
+*/
+class Traversal {
+    public:
+        using word_t = BitMatrix::word_t;
+
+        /**
+        * @brief PATH(u, v) using Depth First Search
+        */
+        template <typename G>
+        bool dfs(const G & g, int u, int v);
+
+        /**
+        * @brief PATH(u, v) using direction-optimizing Breadth First Search: expands the frontier top-down
+        * (frontier -> neighbors) while it's small, and bottom-up (unvisited nodes -> frontier) when it's large.
+        * Bottom-up steps look at the out-edges of unvisited nodes, so the graph must be undirected
+        */
+        template <typename G>
+        bool bfs(const G & g, int u, int v);
+
+
+    private:
+        std::vector<int> stack;  // DFS stack / BFS current frontier
+        std::vector<int> next;  // BFS next frontier
+        std::vector<word_t> visited;  // 1 bit per node
+        std::vector<word_t> frontier;  // BFS current frontier, as a bitset (bottom-up steps)
+
+        static constexpr int alpha = 14;  // switch to bottom-up when frontier edges > unexplored edges / alpha
+        static constexpr int beta = 24;  // switch back to top-down when frontier nodes < n / beta
+
+        template <typename G>
+        void reset(const G & g) {
+            if constexpr (BitsetGraph<G>) visited.assign(g.adjacency().stride(), 0);
+            else visited.assign(BitMatrix::words_for(g.size()), 0);
+            stack.clear();
+            next.clear();
+        }
+
+        bool is_visited(int i) const { return (visited[i / BitMatrix::word_bits] >> (i % BitMatrix::word_bits)) & 1; }
+
+        void mark(int i) { visited[i / BitMatrix::word_bits] |= word_t {1} << (i % BitMatrix::word_bits); }
+
+        /**
+        * @brief visits the unvisited neighbors of w, appending them to `out`. Returns true if v is one of them
+        */
+        template <typename G>
+        bool expand(const G & g, int w, int v, std::vector<int> & out);
+
+        /**
+        * @brief one bottom-up BFS step: every unvisited node with a neighbor in `frontier` joins `next`
+        */
+        template <typename G>
+        bool expand_bottom_up(const G & g, int v);
+};
+
+
+
+template <typename G>
+bool Traversal::expand(const G & g, int w, int v, std::vector<int> & out) {
+    P2_COUNT(nodes_expanded, 1);
+
+    if constexpr (BitsetGraph<G>) {
+        // new nodes = neighbors & ~visited, a whole word at a time
+        const BitMatrix & adj = g.adjacency();
+        const word_t * row = adj.row(w);
+
+        for (std::size_t k = 0; k < adj.stride(); ++k) {
+            P2_COUNT(edges_scanned, std::popcount(row[k]));
+            word_t fresh = row[k] & ~visited[k];
+            if (fresh == 0) continue;
+            visited[k] |= fresh;
+
+            while (fresh) {
+                const int i = k * BitMatrix::word_bits + std::countr_zero(fresh);
+                if (i == v) return true;
+                out.push_back(i);
+                fresh &= fresh - 1;
+            }
+        }
+    }
+    else {
+        for (int i : g.neighbors(w)) {
+            P2_COUNT(edges_scanned, 1);
+            if (is_visited(i)) continue;
+            if (i == v) return true;
+            mark(i);
+            out.push_back(i);
+        }
+    }
+
+    return false;
+}
+
+
+template <typename G>
+bool Traversal::expand_bottom_up(const G & g, int v) {
+    const std::size_t n = g.size();
+
+    // bitset of the current frontier
+    frontier.assign(visited.size(), 0);
+    for (int i : stack) frontier[i / BitMatrix::word_bits] |= word_t {1} << (i % BitMatrix::word_bits);
+
+    for (std::size_t k = 0; k < visited.size(); ++k) {
+        word_t unvisited = ~visited[k];
+
+        while (unvisited) {
+            const std::size_t w = k * BitMatrix::word_bits + std::countr_zero(unvisited);
+            unvisited &= unvisited - 1;
+            if (w >= n) break;
+            P2_COUNT(nodes_expanded, 1);
+
+            bool found = false;
+            if constexpr (BitsetGraph<G>) {
+                const BitMatrix & adj = g.adjacency();
+                const word_t * row = adj.row(w);
+                for (std::size_t j = 0; j < adj.stride() && !found; ++j) {
+                    P2_COUNT(edges_scanned, std::popcount(row[j]));
+                    found = (row[j] & frontier[j]) != 0;
+                }
+            }
+            else {
+                for (int i : g.neighbors(w)) {
+                    P2_COUNT(edges_scanned, 1);
+                    if ((frontier[i / BitMatrix::word_bits] >> (i % BitMatrix::word_bits)) & 1) {
+                        found = true;
+                        break;
+                    }
+                }
+            }
+
+            if (found) {
+                if (static_cast<int>(w) == v) return true;
+                mark(w);
+                next.push_back(w);
+            }
+        }
+    }
+
+    return false;
+}
+
+
+template <typename G>
+bool Traversal::dfs(const G & g, int u, int v) {
+    if (u == v) return true;
+
+    reset(g);
+    mark(u);
+    stack.push_back(u);
+
+    while (!stack.empty()) {
+        const int w = stack.back();
+        stack.pop_back();
+
+        if (expand(g, w, v, stack)) return true;
+    }
+
+    return false;
+}
+
+
+template <typename G>
+bool Traversal::bfs(const G & g, int u, int v) {
+    if (u == v) return true;
+
+    const std::size_t n = g.size();
+    reset(g);
+    mark(u);
+    stack.push_back(u);
+
+    // edges left to explore from unvisited nodes, and edges out of the frontier
+    long long unexplored = g.edge_count();  // O(1), kept by the graph
+    long long frontier_edges = g.degree(u);
+
+    bool bottom_up = false;
+
+    while (!stack.empty()) {
+        next.clear();
+
+        // pick the direction for this step
+        if (!bottom_up && frontier_edges * alpha > unexplored) bottom_up = true;
+        else if (bottom_up && static_cast<long long>(stack.size()) * beta < static_cast<long long>(n)) bottom_up = false;
+
+        if (bottom_up) {
+            if (expand_bottom_up(g, v)) return true;
+        }
+        else {
+            for (int w : stack) {
+                if (expand(g, w, v, next)) return true;
+            }
+        }
+
+        unexplored -= frontier_edges;
+        frontier_edges = 0;
+        for (int w : next) frontier_edges += g.degree(w);
+
+        stack.swap(next);
+    }
+
+    return false;
+}
+
+
+
+#endif
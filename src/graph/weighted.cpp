@@ -0,0 +1,79 @@
+#include "weighted.hpp"
+#include "random.hpp"
+#include "parallel.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+
+
+WeightedGraph::WeightedGraph(std::size_t n, const std::vector<WeightedEdge> & edge_list, bool directed) :
+    offsets(n + 1, 0),
+    targets((directed ? 1 : 2) * edge_list.size()),
+    weights(targets.size()),
+    is_directed {directed},
+    max_w {0}
+{
+    // count degrees
+    for (auto & [u, v, w] : edge_list) {
+        assert(static_cast<std::size_t>(u) < n && static_cast<std::size_t>(v) < n && w >= 0);
+        ++offsets[u + 1];
+        if (!directed) ++offsets[v + 1];
+        max_w = std::max(max_w, w);
+    }
+
+    for (std::size_t u = 0; u < n; ++u) offsets[u + 1] += offsets[u];
+
+    // scatter the edges. In sorted order, the lists come out sorted too (the reverse edges of v, from
+    // smaller nodes, come before the edges of v)
+    std::vector<std::size_t> next (offsets.begin(), offsets.end() - 1);
+    for (auto & [u, v, w] : edge_list) {
+        targets[next[u]] = v;
+        weights[next[u]++] = w;
+        if (!directed) {
+            targets[next[v]] = u;
+            weights[next[v]++] = w;
+        }
+    }
+}
+
+
+WeightedGraph WeightedGraph::random(int n, float prob_edge, weight_t min_weight, weight_t max_weight, bool directed, std::uint64_t seed, unsigned threads) {
+    assert(n > 0);
+    assert(prob_edge > 0 && prob_edge <= 1);
+    assert(0 <= min_weight && min_weight <= max_weight);
+
+    // as RandomUndirectedGraph::sparse, jumping to the next edge of each row with geometric gaps. The
+    // draw of an edge's gap (counter block (i, draw, 0, 2)) also gives its length
+    const Philox rng {seed};
+    const double log_q = std::log1p(-static_cast<double>(prob_edge));
+    const std::uint64_t range = static_cast<std::uint64_t>(max_weight) - min_weight + 1;
+    constexpr int rows_per_block = 1024;
+    const int blocks = (n + rows_per_block - 1) / rows_per_block;
+    std::vector<std::vector<WeightedEdge>> block_edges (blocks);
+
+    parallel_for(0, blocks, [&](std::size_t b) {
+        auto & edge_list = block_edges[b];
+        for (int i = b * rows_per_block; i < std::min<int>(n, (b + 1) * rows_per_block); ++i) {
+            std::uint32_t draw = 0;
+            weight_t w = 0;
+            auto gap = [&]() {
+                const auto random = rng.words({static_cast<std::uint32_t>(i), draw++, 0, 2});
+                w = min_weight + static_cast<weight_t>(random[1] % range);
+                return std::min<double>(std::floor(std::log1p(-unit(random[0])) / log_q), n);
+            };
+
+            // directed: every other node; undirected: the ones after i (the edge is added both ways)
+            long long j = (directed ? 0 : i + 1) + gap();
+            for (; j < n; j += 1 + gap()) {
+                if (j == i) continue;  // not connected to itself
+                edge_list.push_back({i, static_cast<int>(j), w});
+            }
+        }
+    }, threads);
+
+    std::vector<WeightedEdge> edge_list {};
+    for (auto & block : block_edges) edge_list.insert(edge_list.end(), block.begin(), block.end());
+
+    return WeightedGraph(n, edge_list, directed);
+}
@@ -0,0 +1,112 @@
+#ifndef WEIGHTED_HPP
+#define WEIGHTED_HPP
+
+
+#include <vector>
+#include <cassert>
+#include <ostream>
+#include <span>
+#include <cstddef>
+#include <cstdint>
+
+
+
+/**
+ * @brief edge (u, v) of length w
+*/
+struct WeightedEdge {
+    int u;
+    int v;
+    int w;
+};
+
+
+
+/**
+ * @brief graph with integer edge lengths, in CSR format: the neighbors of node u are `targets[offsets[u] ..
+ * offsets[u + 1])`, sorted, and `weights` has the length of each of those edges. Directed or undirected
+*/
+class WeightedGraph {
+    public:
+        using weight_t = int;
+
+        WeightedGraph(): offsets {0}, targets {}, weights {}, is_directed {false}, max_w {0} { }
+
+        /**
+        * @brief builds a graph with n nodes from a list of edges (sorted by u, then v). If it's undirected,
+        * each edge is added in both directions
+        */
+        WeightedGraph(std::size_t n, const std::vector<WeightedEdge> & edge_list, bool directed);
+
+        /**
+        * @brief generates a random graph where every edge is present with probability `prob_edge`, with a
+        * uniform length in [min_weight, max_weight]. Counter-based like RandomUndirectedGraph: the graph only
+        * depends on the seed, whatever the number of threads (0 = one per core). Time and memory are O(n + edges)
+        */
+        static WeightedGraph random(int n, float prob_edge, weight_t min_weight, weight_t max_weight, bool directed, std::uint64_t seed, unsigned threads = 1);
+
+
+        /**
+        * @brief returns the number of nodes
+        */
+        std::size_t size() const { return offsets.size() - 1; }
+
+        /**
+        * @brief returns the number of directed edges (twice the edges of an undirected graph)
+        */
+        std::size_t edge_count() const { return targets.size(); }
+
+        bool directed() const { return is_directed; }
+
+        /**
+        * @brief returns the length of the longest edge
+        */
+        weight_t max_weight() const { return max_w; }
+
+        /**
+        * @brief returns the sorted list of nodes adjacent to u
+        */
+        std::span<const int> neighbors(int u) const {
+            return {targets.data() + offsets[u], targets.data() + offsets[u + 1]};
+        }
+
+        /**
+        * @brief returns the lengths of the edges to `neighbors(u)`
+        */
+        std::span<const weight_t> lengths(int u) const {
+            return {weights.data() + offsets[u], weights.data() + offsets[u + 1]};
+        }
+
+
+        /* overload << operator (adjacency lists of [node, length] pairs) */
+        friend std::ostream & operator << (std::ostream & out, const WeightedGraph & graph) {
+            out << "[";
+            for (std::size_t u = 0; u < graph.size(); ++u) {
+                out << "[";
+                auto adj = graph.neighbors(u);
+                auto len = graph.lengths(u);
+                for (std::size_t i = 0; i < adj.size(); ++i) {
+                    out << "[" << adj[i] << ", " << len[i] << "]";
+                    if (i < adj.size() - 1) out << ", ";  // not last element
+                }
+                out << "]";
+
+                if (u < graph.size() - 1) out << ", ";  // not last element
+            }
+            out << "]";
+
+            return out;
+        }
+
+
+    private:
+        std::vector<std::size_t> offsets;  // size() + 1 entries
+        std::vector<int> targets;  // concatenated adjacency lists
+        std::vector<weight_t> weights;  // length of every edge in targets
+        bool is_directed;
+        weight_t max_w;
+};
+
+
+
+#endif
@@ -0,0 +1,64 @@
+#include "mappedfile.hpp"
+
+#include <stdexcept>
+
+#if defined(_WIN32)
+#include <fstream>
+#include <sstream>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+
+
+#if !defined(_WIN32)
+
+MappedFile::MappedFile(const std::string & path) : data {nullptr}, length {0}, mapped {false}, buffer {} {
+    const int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) throw std::runtime_error("can't open '" + path + "'");
+
+    struct stat info {};
+    if (::fstat(fd, &info) < 0) {
+        ::close(fd);
+        throw std::runtime_error("can't read '" + path + "'");
+    }
+
+    length = info.st_size;
+    if (length > 0) {  // mapping 0 bytes fails
+        void * memory = ::mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+        ::close(fd);
+        if (memory == MAP_FAILED) throw std::runtime_error("can't map '" + path + "'");
+
+        ::madvise(memory, length, MADV_SEQUENTIAL);  // read once, front to back
+        data = static_cast<const char *>(memory);
+        mapped = true;
+    }
+    else ::close(fd);
+}
+
+
+MappedFile::~MappedFile() {
+    if (mapped) ::munmap(const_cast<char *>(data), length);
+}
+
+#else
+
+MappedFile::MappedFile(const std::string & path) : data {nullptr}, length {0}, mapped {false}, buffer {} {
+    std::ifstream file {path, std::ios::binary};
+    if (!file) throw std::runtime_error("can't open '" + path + "'");
+
+    std::ostringstream contents {};
+    contents << file.rdbuf();
+    buffer = contents.str();
+
+    data = buffer.data();
+    length = buffer.size();
+}
+
+
+MappedFile::~MappedFile() = default;
+
+#endif
@@ -0,0 +1,38 @@
+#ifndef MAPPEDFILE_HPP
+#define MAPPEDFILE_HPP
+
+
+#include <string>
+#include <string_view>
+#include <cstddef>
+
+
+
+/**
+ * @brief read-only view of a whole file, mapped in memory (read into a buffer where mmap isn't available)
+*/
+class MappedFile {
+    public:
+        /**
+        * @throws std::runtime_error if the file can't be opened
+        */
+        explicit MappedFile(const std::string & path);
+
+        ~MappedFile();
+
+        MappedFile(const MappedFile &) = delete;
+        MappedFile & operator = (const MappedFile &) = delete;
+
+        std::string_view view() const { return {data, length}; }
+
+
+    private:
+        const char * data;
+        std::size_t length;
+        bool mapped;
+        std::string buffer;  // contents, when not mapped
+};
+
+
+
+#endif
\ No newline at end of file
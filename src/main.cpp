@@ -6,122 +6,471 @@
 #include <chrono>
 #include <cmath>
 #include <algorithm>
+#include <type_traits>
+#include <stdexcept>
+#include <vector>
+#include <span>
+#include <mutex>
+#include <random>
+#include <limits>
+#include <cstdint>
 
 #include "graph/graph.hpp"
+#include "graph/satgraph.hpp"
+#include "graph/sssp.hpp"
+#include "graph/mst.hpp"
+#include "graph/fixedgraph.hpp"
+#include "graph/parallel.hpp"
+#include "graph/random.hpp"
+#include "sat/cdcl.hpp"
 #include "parser.hpp"
+#include "output/writer.hpp"
 
 
 
 
 /* TESTS */
 
-using path_t = std::function<bool(const RandomUndirectedGraph &, int, int)>;  // PATH function wrapper
-using clique_t = std::function<bool(const RandomUndirectedGraph &, int)>;  // CLIQUE function wrapper
+static Writer output {1};  // results to stdout, in JSON
 
+static GraphFormat graph_output = GraphFormat::json;  // how the graphs are output (--graph-format)
+
+template <typename G>
+using path_t = std::function<bool(const G &, int, int)>;  // PATH function wrapper
+
+template <typename G>
+using clique_t = std::function<bool(const G &, int)>;  // CLIQUE function wrapper
+
+template <typename G>
+using generator_t = std::function<G(int, float, std::uint64_t, unsigned)>;  // random graph generator (n, p, seed, threads)
+
+using reader_t = std::function<CNF()>;  // SAT problem reader
+
+using sssp_t = std::function<std::vector<DistanceMatrix::dist_t>(const WeightedGraph &, int)>;  // SSSP function wrapper
+
+using mst_t = std::function<SpanningForest(const WeightedGraph &)>;  // MST function wrapper
+
+
+
+/**
+* @brief runs a PATH algorithm on a graph, outputting the fields of the test (graph, result & duration) in JSON format
+*/
+template <typename G>
+void run_path(Writer & out, const G & graph, int u, int v, path_t<G> func, bool print_graph) {
+    if (print_graph) {
+        out << "\"graph\":";
+        write_graph(out, graph, graph_output);
+        out << ",";
+    }
+
+    // run
+    counters = {};
+    auto tic = std::chrono::high_resolution_clock::now();
+    bool result = func(graph, u, v);
+    auto toc = std::chrono::high_resolution_clock::now();
+
+    auto duration = std::chrono::duration_cast<std::chrono::nanoseconds>(toc-tic).count();
+
+    out << "\"result\":" << (result ? "true" : "false") << ",";
+    if constexpr (counters_enabled) out << "\"counters\":" << counters << ",";
+    out << "\"duration\":" << duration;
+}
+
+
+/**
+* @brief runs a CLIQUE algorithm (and the baseline, if any) on a graph, outputting the fields of the test in JSON format
+*/
+template <typename G>
+void run_clique(Writer & out, const G & graph, int k, clique_t<G> func, bool print_graph, clique_t<G> baseline = nullptr) {
+    if (print_graph) {
+        out << "\"graph\":";
+        write_graph(out, graph, graph_output);
+        out << ",";
+    }
+
+    // run
+    counters = {};
+    auto tic = std::chrono::high_resolution_clock::now();
+    bool result = func(graph, k);
+    auto toc = std::chrono::high_resolution_clock::now();
+
+    auto duration = std::chrono::duration_cast<std::chrono::nanoseconds>(toc-tic).count();
+
+    out << "\"result\":" << (result ? "true" : "false") << ",";
+    if constexpr (counters_enabled) out << "\"counters\":" << counters << ",";
+
+    // run the baseline on the same graph, to compare
+    if (baseline) {
+        auto tic_b = std::chrono::high_resolution_clock::now();
+        baseline(graph, k);
+        auto toc_b = std::chrono::high_resolution_clock::now();
+
+        auto duration_b = std::chrono::duration_cast<std::chrono::nanoseconds>(toc_b-tic_b).count();
+
+        out << "\"duration_seq\":" << duration_b << ",";
+        out << "\"speedup\":" << static_cast<double>(duration_b) / std::max<decltype(duration)>(duration, 1) << ",";
+    }
+
+    out << "\"duration\":" << duration;
+}
+
+
+/**
+* @brief counts the cliques of k nodes of a graph on `threads` threads, outputting the fields of the test (graph, cliques,
+* count & duration) in JSON format. With `list`, every clique is written out as soon as it's found (so the duration
+* includes the output)
+*/
+template <typename G>
+void run_count(Writer & out, const G & graph, int k, unsigned threads, bool print_graph, bool list) {
+    if (print_graph) {
+        out << "\"graph\":";
+        write_graph(out, graph, graph_output);
+        out << ",";
+    }
+
+    // run
+    counters = {};
+    std::uint64_t count;
+    auto tic = std::chrono::high_resolution_clock::now();
+    if (list) {
+        std::mutex out_lock;
+        bool first = true;
+
+        out << "\"cliques\":[";
+        count = graph.list_cliques(k, [&](std::span<const int> clique) {
+            std::lock_guard<std::mutex> guard {out_lock};
+            if (!first) out << ", ";
+            first = false;
+
+            out << "[";
+            for (std::size_t i = 0; i < clique.size(); ++i) {
+                out << clique[i];
+                if (i < clique.size() - 1) out << ", ";
+            }
+            out << "]";
+        }, threads);
+        out << "],";
+    }
+    else count = graph.count_cliques(k, threads);
+    auto toc = std::chrono::high_resolution_clock::now();
+
+    auto duration = std::chrono::duration_cast<std::chrono::nanoseconds>(toc-tic).count();
+
+    out << "\"count\":" << count << ",";
+    if constexpr (counters_enabled) out << "\"counters\":" << counters << ",";
+    out << "\"duration\":" << duration;
+}
+
+
+/**
+* @brief runs an SSSP algorithm from u on a weighted graph, outputting the fields of the test (graph, distance to v,
+* number of nodes reached & duration) in JSON format
+*/
+void run_sssp(Writer & out, const WeightedGraph & graph, int u, int v, sssp_t func, bool print_graph) {
+    if (print_graph) {
+        out << "\"graph\":";
+        write_graph(out, graph, graph_output);
+        out << ",";
+    }
+
+    // run
+    counters = {};
+    auto tic = std::chrono::high_resolution_clock::now();
+    const auto dist = func(graph, u);
+    auto toc = std::chrono::high_resolution_clock::now();
+
+    auto duration = std::chrono::duration_cast<std::chrono::nanoseconds>(toc-tic).count();
+    const auto reached = std::count_if(dist.begin(), dist.end(), [](auto d) { return d < DistanceMatrix::infinity; });
+
+    out << "\"result\":" << (dist[v] < DistanceMatrix::infinity ? "true" : "false") << ",";
+    out << "\"distance\":";
+    if (dist[v] < DistanceMatrix::infinity) out << dist[v];
+    else out << "null";
+    out << ",\"reached\":" << reached << ",";
+    if constexpr (counters_enabled) out << "\"counters\":" << counters << ",";
+    out << "\"duration\":" << duration;
+}
+
+
+/**
+* @brief runs an MST algorithm on a weighted graph, outputting the fields of the test (graph, total weight, number
+* of edges, the edges [u, v, length] of the spanning forest with the graph, & duration) in JSON format
+*/
+void run_mst(Writer & out, const WeightedGraph & graph, mst_t func, bool print_graph) {
+    if (print_graph) {
+        out << "\"graph\":";
+        write_graph(out, graph, graph_output);
+        out << ",";
+    }
+
+    // run
+    counters = {};
+    auto tic = std::chrono::high_resolution_clock::now();
+    const SpanningForest forest = func(graph);
+    auto toc = std::chrono::high_resolution_clock::now();
+
+    auto duration = std::chrono::duration_cast<std::chrono::nanoseconds>(toc-tic).count();
+
+    out << "\"weight\":" << forest.weight << ",";
+    out << "\"edges\":" << forest.edges.size() << ",";
+    if (print_graph) {
+        out << "\"tree\":[";
+        for (std::size_t i = 0; i < forest.edges.size(); ++i) {
+            const auto & e = forest.edges[i];
+            out << "[" << e.u << ", " << e.v << ", " << e.w << "]";
+            if (i < forest.edges.size() - 1) out << ", ";
+        }
+        out << "],";
+    }
+    if constexpr (counters_enabled) out << "\"counters\":" << counters << ",";
+    out << "\"duration\":" << duration;
+}
 
 
 /**
-* @brief generates a RandomUndirectedGraph and tests the performance of a PATH algorithm, outputting it to stdout in JSON format
+* @brief generates a random graph and tests the performance of a PATH algorithm, outputting it to stdout in JSON format.
+* The graph of iteration i is generated from `stream_seed(seed, i)` on `threads` threads
 */
-void test_path(int n, float p, int iter, int u, int v, path_t func, bool print_graph) {
-    std::cout << "{";
-    std::cout << "\"n\":" << n << ",";
-    std::cout << "\"p\":" << p << ",";
-    std::cout << "\"u\":" << u << ",";
-    std::cout << "\"v\":" << v << ",";
+template <typename G>
+void test_path(int n, float p, int iter, std::uint64_t seed, unsigned threads, int u, int v, generator_t<G> generate, path_t<G> func, bool print_graph) {
+    output << "{";
+    output << "\"n\":" << n << ",";
+    output << "\"p\":" << p << ",";
+    output << "\"seed\":" << seed << ",";
+    output << "\"u\":" << u << ",";
+    output << "\"v\":" << v << ",";
 
-    std::cout << "\"tests\":[";
+    output << "\"tests\":[";
 
     for (int i = 0; i < iter; ++i) {
-        std::cout << "{";
+        output << "{";
+        run_path<G>(output, generate(n, p, stream_seed(seed, i), threads), u, v, func, print_graph);
+        output << "}";
+
+        if (i < iter - 1) output << ",";
+        output.flush();
+    }
+
+    output << "]}";
+}
 
-        // create graph
-        RandomUndirectedGraph graph {n, p};
-        if (print_graph) std::cout << "\"graph\":" << graph << ",";
 
-        // run
-        auto tic = std::chrono::high_resolution_clock::now();
-        bool result = func(graph, u, v);
-        auto toc = std::chrono::high_resolution_clock::now();
+/**
+* @brief generates a random graph and tests the performance of a CLIQUE algorithm, outputting it to stdout in JSON format.
+* The graph of iteration i is generated from `stream_seed(seed, i)` on `threads` threads
+*/
+template <typename G>
+void test_clique(int n, float p, int iter, std::uint64_t seed, unsigned threads, int k, generator_t<G> generate, clique_t<G> func, bool print_graph, clique_t<G> baseline = nullptr) {
+    output << "{";
+    output << "\"n\":" << n << ",";
+    output << "\"p\":" << p << ",";
+    output << "\"seed\":" << seed << ",";
+    output << "\"k\":" << k << ",";
 
-        auto duration = std::chrono::duration_cast<std::chrono::nanoseconds>(toc-tic).count();
+    output << "\"tests\":[";
 
-        std::cout << "\"result\":" << (result ? "true" : "false") << ",";
-        std::cout << "\"duration\":" << duration << "}";
+    for (int i = 0; i < iter; ++i) {
+        output << "{";
+        run_clique<G>(output, generate(n, p, stream_seed(seed, i), threads), k, func, print_graph, baseline);
+        output << "}";
 
-        if (i < iter - 1) std::cout << ",";
+        if (i < iter - 1) output << ",";
+        output.flush();
     }
 
-    std::cout << "]}";
+    output << "]}";
 }
 
 
 /**
-* @brief generates a RandomUndirectedGraph and tests the performance of a CLIQUE algorithm, outputting it to stdout in JSON format
+* @brief generates a random graph and counts its cliques of k nodes, outputting it to stdout in JSON format.
+* The graph of iteration i is generated from `stream_seed(seed, i)`, and both the generation and the count use `threads` threads
 */
-void test_clique(int n, float p, int iter, int k, clique_t func, bool print_graph) {
-    std::cout << "{";
-    std::cout << "\"n\":" << n << ",";
-    std::cout << "\"p\":" << p << ",";
-    std::cout << "\"k\":" << k << ",";
+template <typename G>
+void test_count(int n, float p, int iter, std::uint64_t seed, unsigned threads, int k, generator_t<G> generate, bool print_graph, bool list) {
+    output << "{";
+    output << "\"n\":" << n << ",";
+    output << "\"p\":" << p << ",";
+    output << "\"seed\":" << seed << ",";
+    output << "\"k\":" << k << ",";
 
-    std::cout << "\"tests\":[";
+    output << "\"tests\":[";
 
     for (int i = 0; i < iter; ++i) {
-        std::cout << "{";
+        output << "{";
+        run_count<G>(output, generate(n, p, stream_seed(seed, i), threads), k, threads, print_graph, list);
+        output << "}";
 
-        // create graph
-        RandomUndirectedGraph graph {n, p};
-        if (print_graph) std::cout << "\"graph\":" << graph << ",";
+        if (i < iter - 1) output << ",";
+        output.flush();
+    }
 
-        // run
-        auto tic = std::chrono::high_resolution_clock::now();
-        bool result = func(graph, k);
-        auto toc = std::chrono::high_resolution_clock::now();
+    output << "]}";
+}
+
+
+/**
+* @brief generates a random weighted graph and tests the performance of an SSSP algorithm, outputting it to stdout in JSON format.
+* The graph of iteration i is generated from `stream_seed(seed, i)` on `threads` threads
+*/
+void test_sssp(int n, float p, int iter, std::uint64_t seed, unsigned threads, int u, int v, generator_t<WeightedGraph> generate, sssp_t func, bool print_graph) {
+    output << "{";
+    output << "\"n\":" << n << ",";
+    output << "\"p\":" << p << ",";
+    output << "\"seed\":" << seed << ",";
+    output << "\"u\":" << u << ",";
+    output << "\"v\":" << v << ",";
 
-        auto duration = std::chrono::duration_cast<std::chrono::nanoseconds>(toc-tic).count();
+    output << "\"tests\":[";
 
-        std::cout << "\"result\":" << (result ? "true" : "false") << ",";
-        std::cout << "\"duration\":" << duration << "}";
+    for (int i = 0; i < iter; ++i) {
+        output << "{";
+        run_sssp(output, generate(n, p, stream_seed(seed, i), threads), u, v, func, print_graph);
+        output << "}";
 
-        if (i < iter - 1) std::cout << ",";
+        if (i < iter - 1) output << ",";
+        output.flush();
     }
 
-    std::cout << "]}";
+    output << "]}";
 }
 
 
 /**
-* @brief solves a K-SAT problem by transforming it to a k-clique problem
+* @brief generates a random weighted graph and tests the performance of an MST algorithm, outputting it to stdout in JSON format.
+* The graph of iteration i is generated from `stream_seed(seed, i)` on `threads` threads
 */
-void test_sat(int n, float p, std::string problem, bool print_graph) {
-    std::cout << "{";
-    std::cout << "\"n\":" << n << ",";
-    std::cout << "\"p\":" << p << ",";
-    std::cout << "\"problem\":\"" << problem << "\",";
+void test_mst(int n, float p, int iter, std::uint64_t seed, unsigned threads, generator_t<WeightedGraph> generate, mst_t func, bool print_graph) {
+    output << "{";
+    output << "\"n\":" << n << ",";
+    output << "\"p\":" << p << ",";
+    output << "\"seed\":" << seed << ",";
+
+    output << "\"tests\":[";
 
-    // transform K-SAT into K-CLIQUE
+    for (int i = 0; i < iter; ++i) {
+        output << "{";
+        run_mst(output, generate(n, p, stream_seed(seed, i), threads), func, print_graph);
+        output << "}";
+
+        if (i < iter - 1) output << ",";
+        output.flush();
+    }
+
+    output << "]}";
+}
+
+
+/**
+* @brief runs `iter` tests for every (n, p) of a grid on `threads` threads (0 = one per core), streaming
+* to stdout one JSON line per test as soon as it finishes: {"n", "p", "seed", "test", <fields written by `run`>}.
+* Tests run concurrently, so their durations include the contention with the others. The graph of test t of
+* the grid is generated from `stream_seed(seed, t)`, whatever thread runs it
+*/
+template <typename G>
+void sweep(const std::vector<int> & ns, const std::vector<float> & ps, int iter, std::uint64_t seed, unsigned threads, generator_t<G> generate, std::function<void(Writer &, const G &, int)> run) {
+    std::mutex output_lock;
+
+    // tests are handed out in grid order (n, then p, then iteration), so the small ones are usually output first
+    const std::size_t per_n = ps.size() * iter;
+    parallel_for(0, ns.size() * per_n, [&](std::size_t t) {
+        const int n = ns[t / per_n];
+        const float p = ps[t % per_n / iter];
+        const int i = t % iter;
+
+        Writer line {};
+        line << "{\"n\":" << n << ",\"p\":" << p << ",\"seed\":" << seed << ",\"test\":" << i << ",";
+        run(line, generate(n, p, stream_seed(seed, t), 1), n);
+        line << "}\n";
+
+        std::lock_guard<std::mutex> guard {output_lock};
+        output << line.view();
+        output.flush();
+    }, threads);
+}
+
+
+
+/**
+* @brief solves a K-SAT problem by transforming it to a k-clique problem
+*/
+void test_sat(int n, float p, std::string problem, reader_t read, bool print_graph) {
+    // read K-SAT, and transform it into K-CLIQUE (before any output, reading throws if the problem is invalid)
+    counters = {};
     auto tic = std::chrono::high_resolution_clock::now();
-    auto [graph, k] = sat_to_clique(problem);
+    const CNF cnf = read();
+    const SatGraph graph {cnf};  // implicit: O(literals), the adjacency is answered from the clauses
     auto toc_t = std::chrono::high_resolution_clock::now();
 
-    // solve k-clique
-    bool result = graph.k_clique(k);
+    // solve k-clique, k = number of clauses
+    bool result = graph.satisfiable();
     auto toc = std::chrono::high_resolution_clock::now();
 
-    if (print_graph) std::cout << "\"graph\":" << graph << ",";
+    output << "{";
+    output << "\"n\":" << n << ",";
+    output << "\"p\":" << p << ",";
+    output << "\"problem\":\"" << problem << "\",";
+
+    if (print_graph) {
+        output << "\"graph\":";
+        write_graph(output, graph, graph_output);
+        output << ",";
+    }
 
     auto duration = std::chrono::duration_cast<std::chrono::nanoseconds>(toc-tic).count();
     auto duration_transf = std::chrono::duration_cast<std::chrono::nanoseconds>(toc_t-tic).count();
 
-    std::cout << "\"result\":" << (result ? "true" : "false") << ",";
-    std::cout << "\"duration\":" << duration << ",";
-    std::cout << "\"duration_transf\":" << duration_transf;
+    output << "\"result\":" << (result ? "true" : "false") << ",";
+    if constexpr (counters_enabled) output << "\"counters\":" << counters << ",";
+    output << "\"duration\":" << duration << ",";
+    output << "\"duration_transf\":" << duration_transf;
 
-    std::cout << "}";
+    output << "}";
 }
 
 
+/**
+* @brief solves a K-SAT problem with the CDCL solver
+*/
+void test_sat_cdcl(int n, float p, std::string problem, reader_t read) {
+    // read the problem into clauses (before any output, it throws if the problem is invalid)
+    auto tic = std::chrono::high_resolution_clock::now();
+    const CNF cnf = read();
+    CDCLSolver solver {cnf};
+    auto toc_t = std::chrono::high_resolution_clock::now();
+
+    // solve
+    bool result = solver.solve();
+    auto toc = std::chrono::high_resolution_clock::now();
+
+    auto duration = std::chrono::duration_cast<std::chrono::nanoseconds>(toc-tic).count();
+    auto duration_transf = std::chrono::duration_cast<std::chrono::nanoseconds>(toc_t-tic).count();
+
+    output << "{";
+    output << "\"n\":" << n << ",";
+    output << "\"p\":" << p << ",";
+    output << "\"problem\":\"" << problem << "\",";
+    output << "\"result\":" << (result ? "true" : "false") << ",";
+
+    // value of every variable, if satisfiable
+    output << "\"assignment\":";
+    if (result) {
+        output << "{";
+        for (std::size_t v = 1; v <= cnf.variables(); ++v) {
+            output << "\"" << cnf.name(v) << "\":" << (solver.value(v) ? "true" : "false");
+            if (v < cnf.variables()) output << ",";
+        }
+        output << "}";
+    }
+    else output << "null";
+    output << ",";
+
+    output << "\"duration\":" << duration << ",";
+    output << "\"duration_transf\":" << duration_transf;
+
+    output << "}";
+}
+
 
 
 /* CLI */
@@ -129,12 +478,313 @@ void test_sat(int n, float p, std::string problem, bool print_graph) {
 DEFINE_int(n, 5, "size of the graph");
 DEFINE_float(p, 0.5, "probability of an edge between two nodes");
 DEFINE_int(iterations, 1, "number of iterations to execute");
-DEFINE_string(algorithm, "CLIQUE", "algorithm to apply (PATH-DFS, PATH-FW, CLIQUE, SAT-CLIQUE)");
+DEFINE_string(algorithm, "CLIQUE", "algorithm to apply (PATH-DFS, PATH-BFS, PATH-FW, PATH-TC, PATH-UF, PATH-FIXED, SSSP, SSSP-DELTA, MST-KRUSKAL, MST-PRIM, MST-BORUVKA, CLIQUE, CLIQUE-BT, CLIQUE-BBMC, CLIQUE-FIXED, CLIQUE-COUNT, SAT-CLIQUE, SAT-CDCL)");
+DEFINE_int(k, 0, "size of the cliques to find (CLIQUE) or count (CLIQUE-COUNT). 0 = n / 2");
+DEFINE_bool(cliques, false, "output every clique counted (CLIQUE-COUNT), as they're found");
 DEFINE_bool(graph, true, "output the graph");
+DEFINE_string(graph_format, "json", "format of the output graphs: json, base64 (the matrix in n^2 bits, in base64) or zstd (compressed, then base64)");
+DEFINE_bool(csr, false, "generate sparse graphs in CSR format instead of an adjacency matrix (PATH & CLIQUE)");
+DEFINE_int(threads, 1, "number of threads for PATH-FW, PATH-TC, CLIQUE, CLIQUE-COUNT, SSSP-DELTA & MST-BORUVKA and to generate the graphs, or for the tests of a sweep (0 = one per core). With more than 1, CLIQUE reports the speedup over 1 thread");
+DEFINE_string(weights, "1:100", "range 'min:max' of the random integer lengths of the edges (SSSP & MST)");
+DEFINE_bool(directed, false, "generate directed graphs (SSSP)");
+DEFINE_string(n_range, "", "sweep n over 'first:last[:step]' (PATH & CLIQUE), outputting a JSON line per test");
+DEFINE_string(p_range, "", "sweep p over 'first:last:step' (PATH & CLIQUE), outputting a JSON line per test");
+DEFINE_string(input, "", "file to read the SAT problem from (DIMACS CNF or the SAT-PROBLEM syntax), instead of the last argument");
+DEFINE_string(save_graph, "", "write the generated graph (of the first iteration) to a binary file, to rerun algorithms on it with --load-graph");
+DEFINE_string(load_graph, "", "run PATH & CLIQUE on the graph of a binary file (written by --save-graph) instead of a random one. n is the size of the graph");
+DEFINE_int(seed, 0, "seed of the random graphs (0 = a random one, which is output to reproduce them)");
 DEFINE_bool(help, false, "show a list of command-line options");
 
 
 
+/* RUNNERS */
+
+/**
+* @brief values of a range "first:last[:step]" from first up to last (a single value is a range of one)
+* @throws std::invalid_argument if it's malformed
+*/
+template <typename T>
+std::vector<T> parse_range(const std::string & range, T step) {
+    std::vector<double> bounds {};
+    std::istringstream in {range};
+    for (std::string token {}; std::getline(in, token, ':');) {
+        std::size_t end = 0;
+        try { bounds.push_back(std::stod(token, &end)); }
+        catch (const std::exception &) { end = 0; }
+        if (end == 0 || end != token.size()) throw std::invalid_argument("invalid range '" + range + "'");
+    }
+
+    if (bounds.size() == 1) bounds.push_back(bounds[0]);
+    if (bounds.size() == 2) bounds.push_back(step);
+    if (bounds.size() != 3 || bounds[1] < bounds[0] || bounds[2] <= 0) throw std::invalid_argument("invalid range '" + range + "'");
+
+    // from the index, so floating point steps don't accumulate errors
+    const std::size_t count = std::floor((bounds[1] - bounds[0]) / bounds[2] + 1e-9) + 1;
+    std::vector<T> values (count);
+    for (std::size_t i = 0; i < count; ++i) values[i] = static_cast<T>(bounds[0] + i * bounds[2]);
+
+    return values;
+}
+
+
+/**
+* @brief runs the selected SSSP algorithm (shortest paths from node 0, reporting the distance to node n - 1) or MST
+* algorithm on weighted graphs
+*/
+int run_weighted() {
+    const bool sweeping = !FLAG_n_range.empty() || !FLAG_p_range.empty();
+    std::vector<int> ns {FLAG_n};
+    std::vector<float> ps {FLAG_p};
+    std::vector<int> weights {};
+    try {
+        if (!FLAG_n_range.empty()) ns = parse_range<int>(FLAG_n_range, 1);
+        if (!FLAG_p_range.empty()) ps = parse_range<float>(FLAG_p_range, 0.1);
+
+        // bounds only, without the values in between
+        const auto colon = FLAG_weights.find(':');
+        try {
+            weights = parse_range<int>(FLAG_weights.substr(0, colon), 1);
+            if (colon != std::string::npos) weights.push_back(parse_range<int>(FLAG_weights.substr(colon + 1), 1).front());
+        }
+        catch (const std::invalid_argument &) { weights = {-1}; }
+        if (weights.front() < 0 || weights.back() < weights.front()) throw std::invalid_argument("invalid weights '" + FLAG_weights + "'");
+    }
+    catch (const std::invalid_argument & e) {
+        std::cerr << e.what() << "\n";
+        return -1;
+    }
+
+    if (!FLAG_save_graph.empty() || !FLAG_load_graph.empty()) {
+        std::cerr << "Weighted graphs can't be saved or loaded\n";
+        return -1;
+    }
+
+    // the longest path must fit in a distance
+    const int max_n = *std::max_element(ns.begin(), ns.end());
+    if (FLAG_algorithm.starts_with("SSSP") && static_cast<double>(max_n) * weights.back() >= DistanceMatrix::infinity) {
+        std::cerr << "Paths of " << max_n << " edges of length " << weights.back() << " are too long\n";
+        return -1;
+    }
+
+    generator_t<WeightedGraph> generate = [min = weights.front(), max = weights.back()](int n, float p, std::uint64_t seed, unsigned threads) {
+        return WeightedGraph::random(n, p, min, max, FLAG_directed, seed, threads);
+    };
+
+    // in a sweep, the tests already run in parallel
+    const unsigned threads = sweeping ? 1 : FLAG_threads;
+
+    /* SSSP */
+    if (FLAG_algorithm.starts_with("SSSP")) {
+        sssp_t f;
+        if (FLAG_algorithm == "SSSP") {
+            f = &dijkstra;
+        }
+        else if (FLAG_algorithm == "SSSP-DELTA") {
+            f = [threads](const WeightedGraph & graph, int source) { return delta_stepping(graph, source, threads); };
+        }
+        else {
+            std::cerr << "Unknown algorithm '" << FLAG_algorithm << "'\n";
+            return -1;
+        }
+
+        if (sweeping) {
+            sweep<WeightedGraph>(ns, ps, FLAG_iterations, FLAG_seed, FLAG_threads, generate, [f](Writer & out, const WeightedGraph & graph, int n) {
+                out << "\"u\":" << 0 << ",\"v\":" << n - 1 << ",";
+                run_sssp(out, graph, 0, n - 1, f, FLAG_graph);
+            });
+        }
+        else test_sssp(FLAG_n, FLAG_p, FLAG_iterations, FLAG_seed, FLAG_threads, 0, FLAG_n - 1, generate, f, FLAG_graph);
+    }
+
+    /* MST */
+    else {
+        if (FLAG_directed) {
+            std::cerr << "Spanning trees need undirected graphs\n";
+            return -1;
+        }
+
+        mst_t f;
+        if (FLAG_algorithm == "MST-KRUSKAL") {
+            f = &kruskal;
+        }
+        else if (FLAG_algorithm == "MST-PRIM") {
+            f = &prim;
+        }
+        else if (FLAG_algorithm == "MST-BORUVKA") {
+            f = [threads](const WeightedGraph & graph) { return boruvka(graph, threads); };
+        }
+        else {
+            std::cerr << "Unknown algorithm '" << FLAG_algorithm << "'\n";
+            return -1;
+        }
+
+        if (sweeping) {
+            sweep<WeightedGraph>(ns, ps, FLAG_iterations, FLAG_seed, FLAG_threads, generate, [f](Writer & out, const WeightedGraph & graph, int) {
+                run_mst(out, graph, f, FLAG_graph);
+            });
+        }
+        else test_mst(FLAG_n, FLAG_p, FLAG_iterations, FLAG_seed, FLAG_threads, generate, f, FLAG_graph);
+    }
+
+    return 0;
+}
+
+
+/**
+* @brief runs the selected PATH or CLIQUE algorithm on graphs of type G
+*/
+template <typename G>
+int run_graph(generator_t<G> generate) {
+    // sweep mode: a grid of tests run in parallel (each test on a single thread)
+    const bool sweeping = !FLAG_n_range.empty() || !FLAG_p_range.empty();
+    std::vector<int> ns {FLAG_n};
+    std::vector<float> ps {FLAG_p};
+    try {
+        if (!FLAG_n_range.empty()) ns = parse_range<int>(FLAG_n_range, 1);
+        if (!FLAG_p_range.empty()) ps = parse_range<float>(FLAG_p_range, 0.1);
+    }
+    catch (const std::invalid_argument & e) {
+        std::cerr << e.what() << "\n";
+        return -1;
+    }
+
+    if (sweeping && (!FLAG_save_graph.empty() || !FLAG_load_graph.empty())) {
+        std::cerr << "A sweep can't save or load a graph\n";
+        return -1;
+    }
+
+    // the -FIXED algorithms only time FixedGraph, which holds up to 256 nodes (as in p2-bench)
+    if (FLAG_algorithm.ends_with("-FIXED") && std::ranges::max(ns) > 256) {
+        std::cerr << FLAG_algorithm << " needs graphs of up to 256 nodes\n";
+        return -1;
+    }
+
+    // save the first graph generated, as the test runs on it
+    if (!FLAG_save_graph.empty()) {
+        generate = [generate, saved = false](int n, float p, std::uint64_t seed, unsigned threads) mutable {
+            G graph = generate(n, p, seed, threads);
+            if (!saved) graph.save(FLAG_save_graph);
+            saved = true;
+            return graph;
+        };
+    }
+
+    /* PATH */
+    if (FLAG_algorithm.contains("PATH")) {
+        const int v = FLAG_n - 1;
+        const int u = 0;
+        const unsigned threads = sweeping ? 1 : FLAG_threads;  // in a sweep, the tests already run in parallel
+        path_t<G> f;
+
+        if (FLAG_algorithm == "PATH-DFS") {
+            f = &G::path_dfs;
+        }
+        else if (FLAG_algorithm == "PATH-BFS") {
+            f = &G::path_bfs;
+        }
+        else if (FLAG_algorithm == "PATH-FW") {
+            f = [threads](const G & graph, int u, int v) { return graph.path_fw(u, v, threads); };
+        }
+        else if (FLAG_algorithm == "PATH-TC") {
+            f = [threads](const G & graph, int u, int v) { return graph.path_tc(u, v, threads); };
+        }
+        else if (FLAG_algorithm == "PATH-UF") {
+            f = &G::path_uf;
+        }
+        else if (FLAG_algorithm == "PATH-FIXED" && !FLAG_csr) {
+            f = [](const G & graph, int u, int v) {
+                if constexpr (std::is_base_of_v<Graph, G>) {
+                    bool result = false;
+                    with_fixed_graph(graph.adjacency(), [&](const auto & fixed) { result = fixed.path(u, v); });
+                    return result;
+                }
+                return false;
+            };
+        }
+        else {
+            std::cerr << "Unknown algorithm '" << FLAG_algorithm << "'\n";
+            return -1;
+        }
+
+        if (sweeping) {
+            sweep<G>(ns, ps, FLAG_iterations, FLAG_seed, FLAG_threads, generate, [f](Writer & out, const G & graph, int n) {
+                out << "\"u\":" << 0 << ",\"v\":" << n - 1 << ",";
+                run_path<G>(out, graph, 0, n - 1, f, FLAG_graph);
+            });
+        }
+        else test_path<G>(FLAG_n, FLAG_p, FLAG_iterations, FLAG_seed, FLAG_threads, u, v, generate, f, FLAG_graph);
+    }
+
+    /* CLIQUE */
+    else if (FLAG_algorithm.starts_with("CLIQUE")) {
+        const int k = FLAG_k > 0 ? FLAG_k : std::floor(FLAG_n / 2);
+        clique_t<G> f;
+        clique_t<G> baseline = nullptr;
+
+        if (FLAG_algorithm == "CLIQUE-COUNT") {
+            if (sweeping) {
+                sweep<G>(ns, ps, FLAG_iterations, FLAG_seed, FLAG_threads, generate, [](Writer & out, const G & graph, int n) {
+                    const int k = FLAG_k > 0 ? FLAG_k : n / 2;
+                    out << "\"k\":" << k << ",";
+                    run_count<G>(out, graph, k, 1, FLAG_graph, FLAG_cliques);
+                });
+            }
+            else test_count<G>(FLAG_n, FLAG_p, FLAG_iterations, FLAG_seed, FLAG_threads, k, generate, FLAG_graph, FLAG_cliques);
+            return 0;
+        }
+
+        if (FLAG_algorithm == "CLIQUE" && FLAG_threads != 1 && !FLAG_csr && !sweeping) {
+            f = [](const G & graph, int k) {
+                if constexpr (std::is_base_of_v<Graph, G>) return graph.k_clique_parallel(k, FLAG_threads);
+                return false;
+            };
+            baseline = &G::k_clique;
+        }
+        else if (FLAG_algorithm == "CLIQUE") {
+            f = &G::k_clique;
+        }
+        else if (FLAG_algorithm == "CLIQUE-BT" && !FLAG_csr) {
+            f = [](const G & graph, int k) {
+                if constexpr (std::is_base_of_v<Graph, G>) return graph.k_clique_bt(k);
+                return false;
+            };
+        }
+        else if (FLAG_algorithm == "CLIQUE-BBMC" && !FLAG_csr) {
+            f = [](const G & graph, int k) {
+                if constexpr (std::is_base_of_v<Graph, G>) return graph.k_clique_bbmc(k);
+                return false;
+            };
+        }
+        else if (FLAG_algorithm == "CLIQUE-FIXED" && !FLAG_csr) {
+            f = [](const G & graph, int k) {
+                if constexpr (std::is_base_of_v<Graph, G>) {
+                    bool result = false;
+                    with_fixed_graph(graph.adjacency(), [&](const auto & fixed) { result = fixed.k_clique(k); });
+                    return result;
+                }
+                return false;
+            };
+        }
+        else {
+            std::cerr << "Unknown algorithm '" << FLAG_algorithm << "'\n";
+            return -1;
+        }
+
+        if (sweeping) {
+            sweep<G>(ns, ps, FLAG_iterations, FLAG_seed, FLAG_threads, generate, [f](Writer & out, const G & graph, int n) {
+                const int k = FLAG_k > 0 ? FLAG_k : n / 2;
+                out << "\"k\":" << k << ",";
+                run_clique<G>(out, graph, k, f, FLAG_graph);
+            });
+        }
+        else test_clique<G>(FLAG_n, FLAG_p, FLAG_iterations, FLAG_seed, FLAG_threads, k, generate, f, FLAG_graph, baseline);
+    }
+
+    return 0;
+}
+
+
+
 /* MAIN */
 
 int main(int argc, char* argv[]) {
@@ -144,7 +794,20 @@ int main(int argc, char* argv[]) {
     REGISTER_FLAG(argc, argv, p);
     REGISTER_FLAG(argc, argv, algorithm);
     REGISTER_FLAG(argc, argv, iterations);
+    REGISTER_FLAG(argc, argv, k);
+    REGISTER_FLAG(argc, argv, cliques);
     REGISTER_FLAG(argc, argv, graph);
+    REGISTER_FLAG(argc, argv, graph_format);
+    REGISTER_FLAG(argc, argv, csr);
+    REGISTER_FLAG(argc, argv, threads);
+    REGISTER_FLAG(argc, argv, weights);
+    REGISTER_FLAG(argc, argv, directed);
+    REGISTER_FLAG(argc, argv, n_range);
+    REGISTER_FLAG(argc, argv, p_range);
+    REGISTER_FLAG(argc, argv, input);
+    REGISTER_FLAG(argc, argv, save_graph);
+    REGISTER_FLAG(argc, argv, load_graph);
+    REGISTER_FLAG(argc, argv, seed);
     REGISTER_FLAG(argc, argv, help);
 
     if (FLAG_help) {
@@ -157,45 +820,85 @@ int main(int argc, char* argv[]) {
         return 0;
     }
 
+    if (FLAG_seed == 0) FLAG_seed = std::random_device {}() % std::numeric_limits<int>::max() + 1;
+
+    try {
+        graph_output = graph_format(FLAG_graph_format);
+    }
+    catch (const std::invalid_argument & e) {
+        std::cerr << e.what() << "\n";
+        return -1;
+    }
+
     // algorithm name to uppercase
     std::transform(FLAG_algorithm.begin(), FLAG_algorithm.end(), FLAG_algorithm.begin(), ::toupper);
 
     // run tests
 
-    /* PATH */
-    if (FLAG_algorithm.contains("PATH")) {
-        const int v = FLAG_n - 1;
-        const int u = 0;
-        path_t f;
+    /* SSSP & MST */
+    if (FLAG_algorithm.starts_with("SSSP") || FLAG_algorithm.starts_with("MST")) {
+        return run_weighted();
+    }
 
-        if (FLAG_algorithm == "PATH-DFS") { 
-            f = &RandomUndirectedGraph::path_dfs;
+    /* PATH & CLIQUE */
+    if (FLAG_algorithm.contains("PATH") || FLAG_algorithm.starts_with("CLIQUE")) {
+        try {
+            // every iteration runs on a copy of the mapped graph
+            if (!FLAG_load_graph.empty()) {
+                const GraphFile file {FLAG_load_graph};
+                if (file.size() == 0) {
+                    std::cerr << "The graph of '" << FLAG_load_graph << "' is empty\n";
+                    return -1;
+                }
+
+                FLAG_n = file.size();
+                if (FLAG_csr) {
+                    return run_graph<CSRGraph>([&file](int, float, std::uint64_t, unsigned) { return CSRGraph {file}; });
+                }
+                return run_graph<Graph>([&file](int, float, std::uint64_t, unsigned) { return Graph {file}; });
+            }
+
+            if (FLAG_csr) {
+                return run_graph<CSRGraph>(&RandomUndirectedGraph::sparse);
+            }
+            return run_graph<RandomUndirectedGraph>([](int n, float p, std::uint64_t seed, unsigned threads) {
+                return RandomUndirectedGraph {n, p, seed, threads};
+            });
         }
-        else if (FLAG_algorithm == "PATH-FW") {
-            f = &RandomUndirectedGraph::path_fw;
+        catch (const std::runtime_error & e) {
+            std::cerr << e.what() << "\n";
+            return -1;
+        }
+    }
+
+    /* SAT */
+
+    // the problem is read (and timed) by the test
+    const std::string problem = FLAG_input.empty() ? argv[argc - 1] : FLAG_input;
+    reader_t read = [&problem]() { return FLAG_input.empty() ? parse_problem(problem) : read_cnf(problem); };
+
+    try {
+        /* SAT-CLIQUE */
+        if (FLAG_algorithm == "SAT-CLIQUE") {
+            // "((c+b+-c)*(a+b+c)*(-a+b+c))"
+            test_sat(FLAG_n, FLAG_p, problem, read, FLAG_graph);
+        }
+
+        /* SAT-CDCL */
+        else if (FLAG_algorithm == "SAT-CDCL") {
+            test_sat_cdcl(FLAG_n, FLAG_p, problem, read);
         }
         else {
             std::cerr << "Unknown algorithm '" << FLAG_algorithm << "'\n";
             return -1;
         }
-
-        test_path(FLAG_n, FLAG_p, FLAG_iterations, u, v, f, FLAG_graph);
-    }
-
-    /* CLIQUE */
-    else if (FLAG_algorithm == "CLIQUE") {
-        const int k = std::floor(FLAG_n / 2);
-        clique_t f = &RandomUndirectedGraph::k_clique;
-        test_clique(FLAG_n, FLAG_p, FLAG_iterations, k, f, FLAG_graph);
     }
-
-    /* SAT-CLIQUE */
-    else if (FLAG_algorithm == "SAT-CLIQUE") {
-        // "((c+b+-c)*(a+b+c)*(-a+b+c))"
-        test_sat(FLAG_n, FLAG_p, argv[argc - 1], FLAG_graph);
+    catch (const std::invalid_argument & e) {
+        std::cerr << "Invalid problem: " << e.what() << "\n";
+        return -1;
     }
-    else {
-        std::cerr << "Unknown algorithm '" << FLAG_algorithm << "'\n";
+    catch (const std::runtime_error & e) {
+        std::cerr << e.what() << "\n";
         return -1;
     }
 
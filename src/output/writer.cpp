@@ -0,0 +1,279 @@
+#include "writer.hpp"
+
+#include <stdexcept>
+#include <cstring>
+#include <cerrno>
+#include <algorithm>
+
+#if defined(_WIN32)
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+#if defined(P2_ZSTD)
+#include <zstd.h>
+#endif
+
+
+
+Writer::Writer(int fd, std::size_t capacity) : fd {fd}, buffer(std::max<std::size_t>(capacity, 64)), used {0} { }
+
+
+Writer::~Writer() {
+    try { flush(); }
+    catch (const std::runtime_error &) { }  // nowhere to report it
+}
+
+
+char * Writer::reserve(std::size_t size) {
+    if (used + size > buffer.size()) {
+        if (fd >= 0) flush();
+        if (used + size > buffer.size()) buffer.resize(std::max(2 * buffer.size(), used + size));
+    }
+    return buffer.data() + used;
+}
+
+
+Writer & Writer::write(const char * data, std::size_t size) {
+    if (fd >= 0 && size >= buffer.size() / 2) {  // not worth copying
+        flush();
+        write_out(data, size);
+        return *this;
+    }
+
+    std::memcpy(reserve(size), data, size);
+    commit(size);
+    return *this;
+}
+
+
+void Writer::flush() {
+    if (fd < 0) return;
+    write_out(buffer.data(), used);
+    used = 0;
+}
+
+
+void Writer::write_out(const char * data, std::size_t size) {
+    while (size > 0) {
+        const auto written = ::write(fd, data, size);
+        if (written < 0) {
+            if (errno == EINTR) continue;
+            throw std::runtime_error(std::string("can't write the output: ") + std::strerror(errno));
+        }
+        data += written;
+        size -= written;
+    }
+}
+
+
+GraphFormat graph_format(const std::string & name) {
+    if (name == "json") return GraphFormat::json;
+    if (name == "base64") return GraphFormat::base64;
+    if (name == "zstd") {
+#if defined(P2_ZSTD)
+        return GraphFormat::zstd;
+#else
+        throw std::invalid_argument("graph format 'zstd' needs a build with zstd (libzstd wasn't found)");
+#endif
+    }
+    throw std::invalid_argument("unknown graph format '" + name + "'");
+}
+
+
+void write_base64(Writer & out, const unsigned char * data, std::size_t size) {
+    static constexpr char digits[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+    constexpr std::size_t chunk = 3 * 4096;  // bytes encoded per reserve
+
+    for (std::size_t begin = 0; begin < size; begin += chunk) {
+        const std::size_t end = std::min(size, begin + chunk);
+        char * p = out.reserve((end - begin + 2) / 3 * 4);
+        char * const start = p;
+
+        std::size_t i = begin;
+        for (; i + 3 <= end; i += 3) {
+            const std::uint32_t group = data[i] << 16 | data[i + 1] << 8 | data[i + 2];
+            *p++ = digits[group >> 18];
+            *p++ = digits[group >> 12 & 63];
+            *p++ = digits[group >> 6 & 63];
+            *p++ = digits[group & 63];
+        }
+
+        // last 1 or 2 bytes, padded with '='
+        if (i < end) {
+            const std::uint32_t group = data[i] << 16 | (i + 1 < end ? data[i + 1] << 8 : 0);
+            *p++ = digits[group >> 18];
+            *p++ = digits[group >> 12 & 63];
+            *p++ = i + 1 < end ? digits[group >> 6 & 63] : '=';
+            *p++ = '=';
+        }
+
+        out.commit(p - start);
+    }
+}
+
+
+
+/* graphs */
+
+
+/**
+ * @brief concatenates bit strings into bytes (least significant bit first)
+*/
+class BitPacker {
+    public:
+        explicit BitPacker(std::size_t bits) : bytes {}, acc {0}, fill {0} { bytes.reserve((bits + 63) / 64 * 8); }
+
+        /**
+        * @brief appends the lowest `count` bits of a word
+        */
+        void push(std::uint64_t word, unsigned count) {
+            if (count < 64) word &= (std::uint64_t {1} << count) - 1;
+            acc |= word << fill;
+
+            if (fill + count >= 64) {
+                emit(acc, 8);
+                acc = fill ? word >> (64 - fill) : 0;
+                fill = fill + count - 64;
+            }
+            else fill += count;
+        }
+
+        /**
+        * @brief the bytes, with the last one padded with 0s
+        */
+        std::vector<unsigned char> finish() {
+            emit(acc, (fill + 7) / 8);
+            acc = 0;
+            fill = 0;
+            return std::move(bytes);
+        }
+
+
+    private:
+        std::vector<unsigned char> bytes;
+        std::uint64_t acc;  // pending bits
+        unsigned fill;  // number of pending bits
+
+        void emit(std::uint64_t word, unsigned count) {
+            for (unsigned b = 0; b < count; ++b) bytes.push_back(word >> (8 * b));
+        }
+};
+
+
+/**
+ * @brief writes an n x n matrix, given by `row(i, words)`, which fills the words of row i
+*/
+template <typename F>
+static void write_matrix(Writer & out, std::size_t n, std::size_t n_words, GraphFormat format, F row) {
+    std::vector<BitMatrix::word_t> words (n_words);
+
+    if (format == GraphFormat::json) {
+        // "[[0, 1, ...], ...]" as operator <<, a row at a time
+        out << "[";
+        for (std::size_t i = 0; i < n; ++i) {
+            row(i, words.data());
+
+            char * p = out.reserve(3 * n + 4);
+            char * const start = p;
+            *p++ = '[';
+            for (std::size_t j = 0; j < n; ++j) {
+                *p++ = '0' + ((words[j / BitMatrix::word_bits] >> (j % BitMatrix::word_bits)) & 1);
+                *p++ = ',';
+                *p++ = ' ';
+            }
+            if (n > 0) p -= 2;  // not after the last element
+            *p++ = ']';
+            if (i < n - 1) {
+                *p++ = ',';
+                *p++ = ' ';
+            }
+            out.commit(p - start);
+        }
+        out << "]";
+        return;
+    }
+
+    BitPacker packer {n * n};
+    for (std::size_t i = 0; i < n; ++i) {
+        row(i, words.data());
+        for (std::size_t k = 0; k * BitMatrix::word_bits < n; ++k) {
+            packer.push(words[k], std::min<std::size_t>(BitMatrix::word_bits, n - k * BitMatrix::word_bits));
+        }
+    }
+    std::vector<unsigned char> bytes = packer.finish();
+
+#if defined(P2_ZSTD)
+    if (format == GraphFormat::zstd) {
+        std::vector<unsigned char> compressed (ZSTD_compressBound(bytes.size()));
+        const std::size_t length = ZSTD_compress(compressed.data(), compressed.size(), bytes.data(), bytes.size(), 1);
+        if (ZSTD_isError(length)) throw std::runtime_error(std::string("can't compress the graph: ") + ZSTD_getErrorName(length));
+        compressed.resize(length);
+        bytes = std::move(compressed);
+    }
+#endif
+
+    out << "{\"n\":" << n << ",\"format\":\"" << (format == GraphFormat::zstd ? "zstd" : "base64") << "\",\"data\":\"";
+    write_base64(out, bytes.data(), bytes.size());
+    out << "\"}";
+}
+
+
+void write_graph(Writer & out, const Graph & graph, GraphFormat format) {
+    const BitMatrix & matrix = graph.adjacency();
+    write_matrix(out, graph.size(), matrix.stride(), format, [&](std::size_t i, BitMatrix::word_t * words) {
+        std::copy_n(matrix.row(i), matrix.stride(), words);
+    });
+}
+
+
+void write_graph(Writer & out, const SatGraph & graph, GraphFormat format) {
+    write_matrix(out, graph.size(), graph.stride(), format, [&](std::size_t i, BitMatrix::word_t * words) {
+        graph.copy_row(i, words);
+    });
+}
+
+
+void write_graph(Writer & out, const CSRGraph & graph, GraphFormat format) {
+    const std::size_t n = graph.size();
+
+    if (format != GraphFormat::json) {
+        write_matrix(out, n, BitMatrix::words_for(n), format, [&](std::size_t i, BitMatrix::word_t * words) {
+            std::fill_n(words, BitMatrix::words_for(n), 0);
+            for (int v : graph.neighbors(i)) words[v / BitMatrix::word_bits] |= BitMatrix::word_t {1} << (v % BitMatrix::word_bits);
+        });
+        return;
+    }
+
+    // adjacency lists, as operator <<
+    out << "[";
+    for (std::size_t u = 0; u < n; ++u) {
+        out << "[";
+        auto adj = graph.neighbors(u);
+        for (std::size_t i = 0; i < adj.size(); ++i) {
+            out << adj[i];
+            if (i < adj.size() - 1) out << ", ";
+        }
+        out << "]";
+        if (u < n - 1) out << ", ";
+    }
+    out << "]";
+}
+
+
+void write_graph(Writer & out, const WeightedGraph & graph, GraphFormat) {
+    out << "[";
+    for (std::size_t u = 0; u < graph.size(); ++u) {
+        out << "[";
+        auto adj = graph.neighbors(u);
+        auto len = graph.lengths(u);
+        for (std::size_t i = 0; i < adj.size(); ++i) {
+            out << "[" << adj[i] << ", " << len[i] << "]";
+            if (i < adj.size() - 1) out << ", ";
+        }
+        out << "]";
+        if (u < graph.size() - 1) out << ", ";
+    }
+    out << "]";
+}
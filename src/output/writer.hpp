@@ -0,0 +1,163 @@
+#ifndef WRITER_HPP
+#define WRITER_HPP
+
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <charconv>
+#include <type_traits>
+#include <cstddef>
+#include <cstdint>
+
+#include "graph.hpp"
+#include "satgraph.hpp"
+#include "weighted.hpp"
+#include "counters.hpp"
+
+
+
+/**
+ * @brief buffered output to a file descriptor
+ *
+ * Everything is appended to one reusable buffer (numbers with `std::to_chars`, so no locale or stream state),
+ * which goes out with a single `write` when it fills up or on `flush()`. Without a file descriptor, it's an
+ * in-memory buffer that grows as needed (see `view()`).
+*/
+class Writer {
+    public:
+        static constexpr std::size_t default_capacity = 1 << 20;
+
+        /**
+        * @param fd file descriptor to write to (-1 = keep everything in memory)
+        */
+        explicit Writer(int fd = -1, std::size_t capacity = default_capacity);
+
+        /**
+        * @brief flushes what's left
+        */
+        ~Writer();
+
+        Writer(const Writer &) = delete;
+        Writer & operator = (const Writer &) = delete;
+
+
+        /**
+        * @brief returns a pointer to `size` free bytes at the end of the buffer (flushing it or growing it if
+        * needed), to be filled and then committed with `commit()`
+        */
+        char * reserve(std::size_t size);
+
+        /**
+        * @brief adds `size` bytes written after a `reserve()`
+        */
+        void commit(std::size_t size) { used += size; }
+
+        /**
+        * @brief appends bytes (big blocks go straight out, without a copy)
+        */
+        Writer & write(const char * data, std::size_t size);
+
+        /**
+        * @brief writes the buffer out, if there's a file descriptor
+        * @throws std::runtime_error if it can't be written
+        */
+        void flush();
+
+
+        /**
+        * @brief contents not written out yet
+        */
+        std::string_view view() const { return {buffer.data(), used}; }
+
+        /**
+        * @brief drops the contents not written out yet
+        */
+        void clear() { used = 0; }
+
+
+        Writer & operator << (std::string_view text) { return write(text.data(), text.size()); }
+
+        Writer & operator << (const char * text) { return *this << std::string_view {text}; }
+
+        Writer & operator << (const std::string & text) { return *this << std::string_view {text}; }
+
+        Writer & operator << (char c) {
+            *reserve(1) = c;
+            commit(1);
+            return *this;
+        }
+
+        Writer & operator << (bool value) { return *this << (value ? "true" : "false"); }
+
+        /**
+        * @brief numbers: integers in full, floating point as `std::ostream` does by default (6 significant digits, as %g)
+        */
+        template <typename T> requires (std::is_arithmetic_v<T> && !std::is_same_v<T, bool> && !std::is_same_v<T, char>)
+        Writer & operator << (T value) {
+            constexpr std::size_t max_chars = 32;
+            char * p = reserve(max_chars);
+            if constexpr (std::is_floating_point_v<T>) commit(std::to_chars(p, p + max_chars, value, std::chars_format::general, 6).ptr - p);
+            else commit(std::to_chars(p, p + max_chars, value).ptr - p);
+            return *this;
+        }
+
+        /* JSON object */
+        Writer & operator << (const Counters & c) {
+            c.write_json(*this);
+            return *this;
+        }
+
+
+    private:
+        int fd;
+        std::vector<char> buffer;
+        std::size_t used;  // bytes of buffer in use
+
+        /**
+        * @brief writes bytes to the file descriptor, all of them
+        */
+        void write_out(const char * data, std::size_t size);
+};
+
+
+
+/**
+ * @brief how graphs are written (`--graph-format`)
+*/
+enum class GraphFormat {
+    json,  // adjacency matrix (lists for CSRGraph & WeightedGraph), as their operator <<
+    base64,  // {"n", "format", "data"}: the matrix rows, packed in n^2 bits (bit j of row i is bit (i n + j) % 8 of byte (i n + j) / 8), in base64
+    zstd  // same as base64, compressed with zstd before the base64 encoding
+};
+
+
+/**
+ * @brief format named `name` (json, base64 or zstd)
+ * @throws std::invalid_argument if there's no such format, or zstd isn't built in
+*/
+GraphFormat graph_format(const std::string & name);
+
+
+/**
+ * @brief appends data in base64
+*/
+void write_base64(Writer & out, const unsigned char * data, std::size_t size);
+
+
+/* graphs */
+
+void write_graph(Writer & out, const Graph & graph, GraphFormat format);
+
+void write_graph(Writer & out, const CSRGraph & graph, GraphFormat format);
+
+void write_graph(Writer & out, const SatGraph & graph, GraphFormat format);
+
+/**
+ * @brief weighted graphs are always written as JSON lists (the lengths can't be packed in bits)
+*/
+void write_graph(Writer & out, const WeightedGraph & graph, GraphFormat format);
+
+
+
+#endif
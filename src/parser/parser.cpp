@@ -5,11 +5,27 @@
 #include <cstring>
 #include <cstdlib>
 #include <iostream>
+#include <algorithm>
 
 
 std::string FLAGhelpstring = "";
 
 
+std::string flagname(std::string name) {
+  std::replace(name.begin(), name.end(), '_', '-');
+  return name;
+}
+
+
+/**
+ * @brief checks if a token is the flag `--name`, or `--name=value`
+*/
+static bool isFlag(const std::string & token, const std::string & name) {
+  const std::string flag = "--" + flagname(name);
+  return token == flag || token.starts_with(flag + "=");
+}
+
+
 
 // TODO: templetarize
 
@@ -27,7 +43,7 @@ void parseFlag(int argc, char** argv, std::string name, bool & val) {
       val = (token.compare("true") == 0);
       return;
     }
-    if (token.compare("--" + name) == 0) {
+    if (token == "--" + flagname(name)) {
       if (i == argc - 1) {
         // If this is the last flag in the list
         val = true;
@@ -35,7 +51,7 @@ void parseFlag(int argc, char** argv, std::string name, bool & val) {
       }
       found = true;
     }
-    if (token.compare("--no" + name) == 0) {
+    if (token == "--no" + flagname(name)) {
       val = false;
       return;
     }
@@ -52,7 +68,7 @@ void parseFlag(int argc, char** argv, std::string name, float & val) {
       val = std::atof(argv[i]);
       return;
     }
-    if (token.contains("--" + name)) {
+    if (isFlag(token, name)) {
       if (token.contains("=")) {  // check for arg=value
         val = std::stof(token.substr(token.find("=") + 1));
         return;
@@ -72,7 +88,7 @@ void parseFlag(int argc, char** argv, std::string name, int & val) {
       val = std::atoi(argv[i]);
       return;
     }
-    if (token.contains("--" + name)) {
+    if (isFlag(token, name)) {
       if (token.contains("=")) {  // check for arg=value
         val = std::stoi(token.substr(token.find("=") + 1));
         return;
@@ -92,7 +108,7 @@ void parseFlag(int argc, char** argv, std::string name, std::string & val) {
       val = token;
       return;
     }
-    if (token.contains("--" + name)) {
+    if (isFlag(token, name)) {
       if (token.contains("=")) {  // check for arg=value
         val = token.substr(token.find("=") + 1);
         return;
@@ -116,7 +132,7 @@ void parseFlag(int argc, char** argv, std::string name, std::vector<float> & val
       }
       return;
     }
-    if (token.compare("--" + name) == 0) {
+    if (token == "--" + flagname(name)) {
       found = true;
     }
   }
@@ -135,7 +151,7 @@ void parseFlag(int argc, char** argv, std::string name, std::vector<std::string>
       }
       return;
     }
-    if (token.compare("--" + name) == 0) {
+    if (token == "--" + flagname(name)) {
       found = true;
     }
   }
@@ -17,6 +17,11 @@ if (!(cond)) { \
 
 extern std::string FLAGhelpstring;
 
+/**
+ * @brief command-line name of a flag: its name with '-' instead of '_' (n_range -> --n-range)
+*/
+std::string flagname(std::string name);
+
 
 #define DEFINE_FLAG(type, flag_name, default_value, description) \
 std::string FLAGname_##flag_name = #flag_name; \
@@ -40,7 +45,7 @@ DEFINE_FLAG(int, flag_name, default_value, description)
 DEFINE_FLAG(std::vector<float>, flag_name, default_value, description)
 
 #define REGISTER_FLAG(argc, argv, flag_name) \
-FLAGhelpstring.append("\n  --" #flag_name " ["); \
+FLAGhelpstring.append("\n  --" + flagname(#flag_name) + " ["); \
 FLAGhelpstring.append(FLAGdefaultvalue_##flag_name); \
 FLAGhelpstring.append("]\t"); \
 FLAGhelpstring.append(FLAGhelp_##flag_name); \
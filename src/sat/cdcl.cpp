@@ -0,0 +1,473 @@
+#include "cdcl.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+
+
+
+/* variable order */
+
+void CDCLSolver::VariableHeap::insert(int v) {
+    if (static_cast<int>(index.size()) <= v) index.resize(v + 1, -1);
+    if (index[v] >= 0) return;
+
+    index[v] = heap.size();
+    heap.push_back(v);
+    up(heap.size() - 1);
+}
+
+
+int CDCLSolver::VariableHeap::pop() {
+    const int top = heap.front();
+    index[top] = -1;
+
+    heap.front() = heap.back();
+    heap.pop_back();
+    if (!heap.empty()) {
+        index[heap.front()] = 0;
+        down(0);
+    }
+
+    return top;
+}
+
+
+void CDCLSolver::VariableHeap::up(std::size_t i) {
+    const int v = heap[i];
+    while (i > 0) {
+        const std::size_t parent = (i - 1) / 2;
+        if (activity[heap[parent]] >= activity[v]) break;
+
+        heap[i] = heap[parent];
+        index[heap[i]] = i;
+        i = parent;
+    }
+
+    heap[i] = v;
+    index[v] = i;
+}
+
+
+void CDCLSolver::VariableHeap::down(std::size_t i) {
+    const int v = heap[i];
+    while (2 * i + 1 < heap.size()) {
+        std::size_t child = 2 * i + 1;
+        if (child + 1 < heap.size() && activity[heap[child + 1]] > activity[heap[child]]) ++child;
+        if (activity[heap[child]] <= activity[v]) break;
+
+        heap[i] = heap[child];
+        index[heap[i]] = i;
+        i = child;
+    }
+
+    heap[i] = v;
+    index[v] = i;
+}
+
+
+
+
+/* setup */
+
+CDCLSolver::CDCLSolver(const CNF & formula) :
+    n_vars {formula.variables()},
+    unsatisfiable {false},
+    arena {},
+    watches (2 * n_vars),
+    values (2 * n_vars, l_undef),
+    level (n_vars, 0),
+    reason (n_vars, no_reason),
+    polarity (n_vars, false),
+    trail {},
+    trail_lim {},
+    qhead {0},
+    activity (n_vars, 0),
+    var_inc {1},
+    order {activity},
+    cla_inc {1},
+    max_learnts {std::max<std::size_t>(formula.size() / 3, 100)},
+    n_learnts {0},
+    seen (n_vars, false),
+    learnt_clause {},
+    model (n_vars, false),
+    statistics {}
+{
+    trail.reserve(n_vars);
+    arena.reserve(formula.literals.size() + header_size * formula.size());
+    for (std::size_t v = 0; v < n_vars; ++v) order.insert(v);
+
+    // a literal can't be watched by more clauses than it appears in: allocate every watch list once
+    {
+        std::vector<std::uint32_t> occurrences (2 * n_vars, 0);
+        for (auto & x : formula.literals) ++occurrences[2 * (std::abs(x) - 1) + (x < 0)];
+        for (std::size_t p = 0; p < 2 * n_vars; ++p) watches[p].reserve(occurrences[p]);
+    }
+
+    std::vector<lit_t> lits {};
+    for (std::size_t i = 0; i < formula.size() && !unsatisfiable; ++i) {
+        lits.clear();
+        for (auto & x : formula.clause(i)) lits.push_back(2 * (std::abs(x) - 1) + (x < 0));
+
+        // drop repeated literals, and clauses that are always true (p + -p)
+        std::sort(lits.begin(), lits.end());
+        lits.erase(std::unique(lits.begin(), lits.end()), lits.end());
+
+        bool tautology = false;
+        for (std::size_t j = 1; j < lits.size(); ++j) tautology |= lits[j] == (lits[j - 1] ^ 1);
+        if (tautology) continue;
+
+        if (lits.empty()) unsatisfiable = true;
+        else if (lits.size() == 1) {
+            if (value_of(lits[0]) == l_false) unsatisfiable = true;
+            else if (value_of(lits[0]) == l_undef) assign(lits[0], no_reason);
+        }
+        else add_clause(lits, false);
+    }
+}
+
+
+int CDCLSolver::add_clause(const std::vector<lit_t> & lits, bool learnt) {
+    const int c = arena.size();
+    arena.push_back(static_cast<lit_t>(lits.size() << 1 | learnt));
+    arena.push_back(std::bit_cast<lit_t>(0.0f));
+    arena.insert(arena.end(), lits.begin(), lits.end());
+
+    watches[lits[0]].push_back({c, lits[1]});
+    watches[lits[1]].push_back({c, lits[0]});
+
+    return c;
+}
+
+
+
+
+/* search */
+
+void CDCLSolver::assign(lit_t p, int from) {
+    const int v = var(p);
+    values[p] = l_true;
+    values[p ^ 1] = l_false;
+    level[v] = decision_level();
+    reason[v] = from;
+    trail.push_back(p);
+}
+
+
+int CDCLSolver::propagate() {
+    int conflict = no_reason;
+
+    while (qhead < trail.size()) {
+        const lit_t p = trail[qhead++];  // true: visit the clauses watching its negation
+        const lit_t false_lit = p ^ 1;
+        std::vector<Watch> & ws = watches[false_lit];
+        ++statistics.propagations;
+
+        std::size_t i = 0;
+        std::size_t j = 0;
+        while (i < ws.size()) {
+            const Watch w = ws[i++];
+            if (value_of(w.blocker) == l_true) {
+                ws[j++] = w;
+                continue;
+            }
+
+            // the false literal goes second
+            lit_t * lits = literals(w.clause);
+            if (lits[0] == false_lit) std::swap(lits[0], lits[1]);
+
+            const lit_t first = lits[0];
+            const Watch kept {w.clause, first};
+            if (first != w.blocker && value_of(first) == l_true) {
+                ws[j++] = kept;
+                continue;
+            }
+
+            // look for another literal to watch
+            const std::uint32_t size = clause_size(w.clause);
+            bool moved = false;
+            for (std::uint32_t k = 2; k < size; ++k) {
+                if (value_of(lits[k]) != l_false) {
+                    std::swap(lits[1], lits[k]);
+                    watches[lits[1]].push_back(kept);
+                    moved = true;
+                    break;
+                }
+            }
+            if (moved) continue;
+
+            // every other literal is false: the first one is implied, unless it's false too
+            ws[j++] = kept;
+            if (value_of(first) == l_false) {
+                conflict = w.clause;
+                qhead = trail.size();
+                while (i < ws.size()) ws[j++] = ws[i++];
+            }
+            else assign(first, w.clause);
+        }
+
+        ws.resize(j);
+        if (conflict != no_reason) break;
+    }
+
+    return conflict;
+}
+
+
+int CDCLSolver::analyze(int conflict) {
+    learnt_clause.assign(1, 0);  // room for the asserting literal
+
+    int paths = 0;  // literals of the current level still to be resolved
+    lit_t p = -1;
+    std::size_t index = trail.size();
+
+    do {
+        if (learnt(conflict)) bump_clause(conflict);
+
+        const lit_t * lits = literals(conflict);
+        const std::uint32_t size = clause_size(conflict);
+        for (std::uint32_t j = (p == -1 ? 0 : 1); j < size; ++j) {  // the first literal of a reason is p
+            const lit_t q = lits[j];
+            const int v = var(q);
+            if (seen[v] || level[v] == 0) continue;
+
+            seen[v] = true;
+            bump_variable(v);
+            if (level[v] >= decision_level()) ++paths;
+            else learnt_clause.push_back(q);
+        }
+
+        // last assigned literal of the clause
+        while (!seen[var(trail[--index])]);
+        p = trail[index];
+        conflict = reason[var(p)];
+        seen[var(p)] = false;
+        --paths;
+    } while (paths > 0);
+
+    learnt_clause[0] = p ^ 1;
+
+    // drop the literals implied by others of the clause
+    std::size_t kept = 1;
+    for (std::size_t i = 1; i < learnt_clause.size(); ++i) {
+        const int v = var(learnt_clause[i]);
+        bool redundant = reason[v] != no_reason;
+
+        if (redundant) {
+            const lit_t * lits = literals(reason[v]);
+            const std::uint32_t size = clause_size(reason[v]);
+            for (std::uint32_t j = 1; j < size && redundant; ++j) {
+                redundant = seen[var(lits[j])] || level[var(lits[j])] == 0;
+            }
+        }
+
+        if (!redundant) std::swap(learnt_clause[kept++], learnt_clause[i]);  // the dropped ones stay at the end, to clear them
+    }
+    for (std::size_t i = 1; i < learnt_clause.size(); ++i) seen[var(learnt_clause[i])] = false;
+    learnt_clause.resize(kept);
+
+    // backjump to the highest level of the rest, whose literal is watched second
+    if (learnt_clause.size() == 1) return 0;
+
+    std::size_t max_i = 1;
+    for (std::size_t i = 2; i < learnt_clause.size(); ++i) {
+        if (level[var(learnt_clause[i])] > level[var(learnt_clause[max_i])]) max_i = i;
+    }
+    std::swap(learnt_clause[1], learnt_clause[max_i]);
+
+    return level[var(learnt_clause[1])];
+}
+
+
+void CDCLSolver::backtrack(int target_level) {
+    if (decision_level() <= target_level) return;
+
+    for (std::size_t i = trail.size(); i-- > trail_lim[target_level];) {
+        const int v = var(trail[i]);
+        polarity[v] = trail[i] & 1;
+        values[trail[i]] = l_undef;
+        values[trail[i] ^ 1] = l_undef;
+        reason[v] = no_reason;
+        order.insert(v);
+    }
+
+    qhead = trail_lim[target_level];
+    trail.resize(trail_lim[target_level]);
+    trail_lim.resize(target_level);
+}
+
+
+std::int8_t CDCLSolver::search(std::size_t budget) {
+    std::size_t conflicts = 0;
+
+    while (true) {
+        const int conflict = propagate();
+
+        if (conflict != no_reason) {
+            ++conflicts;
+            ++statistics.conflicts;
+            if (decision_level() == 0) return l_false;
+
+            backtrack(analyze(conflict));
+
+            if (learnt_clause.size() == 1) assign(learnt_clause[0], no_reason);
+            else {
+                const int c = add_clause(learnt_clause, true);
+                bump_clause(c);
+                assign(learnt_clause[0], c);
+                ++n_learnts;
+            }
+            ++statistics.learnt;
+
+            var_inc /= 0.95;
+            cla_inc /= 0.999f;
+            continue;
+        }
+
+        if (conflicts >= budget) {
+            backtrack(0);
+            return l_undef;
+        }
+
+        if (n_learnts >= max_learnts + trail.size()) reduce_learnts();
+
+        // branch on the most active unassigned variable
+        int next = -1;
+        while (!order.empty()) {
+            const int v = order.pop();
+            if (values[2 * v] == l_undef) {
+                next = v;
+                break;
+            }
+        }
+
+        if (next < 0) return l_true;  // every variable is assigned without conflict
+
+        ++statistics.decisions;
+        trail_lim.push_back(trail.size());
+        assign(2 * next + polarity[next], no_reason);
+    }
+}
+
+
+/**
+ * @brief x-th element (from 0) of the Luby sequence 1, 1, 2, 1, 1, 2, 4, 1, 1, 2, ...
+*/
+static std::size_t luby(std::size_t x) {
+    std::size_t size = 1;
+    std::size_t seq = 0;
+    while (size < x + 1) {
+        ++seq;
+        size = 2 * size + 1;
+    }
+
+    while (size - 1 != x) {
+        size = (size - 1) >> 1;
+        --seq;
+        x = x % size;
+    }
+
+    return std::size_t {1} << seq;
+}
+
+
+bool CDCLSolver::solve() {
+    if (unsatisfiable) return false;
+
+    std::int8_t status = l_undef;
+    for (std::size_t restart = 0; status == l_undef; ++restart) {
+        status = search(100 * luby(restart));
+        if (status == l_undef) ++statistics.restarts;
+    }
+
+    if (status == l_false) {
+        unsatisfiable = true;
+        return false;
+    }
+
+    for (std::size_t v = 0; v < n_vars; ++v) model[v] = values[2 * v] == l_true;
+    backtrack(0);
+
+    return true;
+}
+
+
+
+
+/* activities */
+
+void CDCLSolver::bump_variable(int v) {
+    activity[v] += var_inc;
+    if (activity[v] > 1e100) {  // rescale everything before it overflows
+        for (auto & a : activity) a *= 1e-100;
+        var_inc *= 1e-100;
+    }
+
+    order.increased(v);
+}
+
+
+void CDCLSolver::bump_clause(int c) {
+    set_activity(c, activity_of(c) + cla_inc);
+    if (activity_of(c) > 1e20f) {
+        for (std::size_t d = 0; d < arena.size(); d += header_size + clause_size(d)) {
+            if (learnt(d)) set_activity(d, activity_of(d) * 1e-20f);
+        }
+        cla_inc *= 1e-20f;
+    }
+}
+
+
+void CDCLSolver::reduce_learnts() {
+    // clauses that are the reason of an assignment must stay
+    auto locked = [&](int c) {
+        const lit_t first = literals(c)[0];
+        return reason[var(first)] == c && value_of(first) == l_true;
+    };
+
+    std::vector<int> learnts {};
+    for (std::size_t c = 0; c < arena.size(); c += header_size + clause_size(c)) {
+        if (learnt(c)) learnts.push_back(c);
+    }
+    std::sort(learnts.begin(), learnts.end(), [&](int a, int b) { return activity_of(a) < activity_of(b); });
+
+    std::vector<int> removed {};
+    for (std::size_t i = 0; i < learnts.size() / 2; ++i) {
+        const int c = learnts[i];
+        if (clause_size(c) > 2 && !locked(c)) removed.push_back(c);
+    }
+    std::sort(removed.begin(), removed.end());
+    n_learnts -= removed.size();
+
+    // compact the arena. The new position of every kept clause is left in its old activity, to update the reasons
+    std::vector<lit_t> kept {};
+    kept.reserve(arena.size());
+
+    auto next_removed = removed.begin();
+    for (std::size_t c = 0; c < arena.size();) {
+        const std::size_t size = clause_size(c);
+
+        if (next_removed != removed.end() && *next_removed == static_cast<int>(c)) ++next_removed;
+        else {
+            const int moved_to = kept.size();
+            kept.insert(kept.end(), arena.begin() + c, arena.begin() + c + header_size + size);
+            arena[c + 1] = moved_to;
+        }
+
+        c += header_size + size;
+    }
+
+    for (auto & r : reason) {
+        if (r != no_reason) r = arena[r + 1];
+    }
+
+    arena = std::move(kept);
+
+    for (auto & ws : watches) ws.clear();
+    for (std::size_t c = 0; c < arena.size(); c += header_size + clause_size(c)) {
+        const lit_t * lits = literals(c);
+        watches[lits[0]].push_back({static_cast<int>(c), lits[1]});
+        watches[lits[1]].push_back({static_cast<int>(c), lits[0]});
+    }
+
+    max_learnts += max_learnts / 10;
+}
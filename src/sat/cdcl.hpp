@@ -0,0 +1,177 @@
+#ifndef CDCL_HPP
+#define CDCL_HPP
+
+
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include <bit>
+
+#include "cnf.hpp"
+
+
+
+/**
+ * @brief conflict-driven clause learning SAT solver
+ *
+ * Unit propagation watches two literals per clause, so only the clauses watching a literal that becomes
+ * false are visited. Each conflict is analyzed back to its first unique implication point, and the learnt
+ * clause makes the search backjump. Branching picks the unassigned variable with the highest activity
+ * (VSIDS: variables in recent conflicts are bumped, and all activities decay), with the last polarity it
+ * had. The search restarts following the Luby sequence, and half of the learnt clauses (the least active)
+ * are dropped whenever they grow past a limit.
+*/
+class CDCLSolver {
+    public:
+        /**
+        * @brief search statistics
+        */
+        struct Stats {
+            std::size_t decisions = 0;
+            std::size_t propagations = 0;
+            std::size_t conflicts = 0;
+            std::size_t restarts = 0;
+            std::size_t learnt = 0;  // clauses learnt (including the ones dropped since)
+        };
+
+        explicit CDCLSolver(const CNF & formula);
+
+        /**
+        * @brief searches for a satisfying assignment
+        * @return true if the formula is satisfiable
+        */
+        bool solve();
+
+        /**
+        * @brief value of variable v (numbered from 1) in the assignment found by solve()
+        */
+        bool value(int v) const { return model[v - 1]; }
+
+        const Stats & stats() const { return statistics; }
+
+
+    private:
+        // literal of variable x (from 0): 2x, its negation: 2x + 1
+        using lit_t = int;
+        static constexpr int no_reason = -1;
+
+        // values of a literal
+        static constexpr std::int8_t l_true = 1;
+        static constexpr std::int8_t l_false = -1;
+        static constexpr std::int8_t l_undef = 0;
+
+        // clauses are stored one after another in `arena`, each as a header (size << 1 | learnt, activity) followed
+        // by its literals, and referred to by the position of their header. The watched literals are the first two
+        static constexpr int header_size = 2;
+
+        struct Watch {
+            int clause;
+            lit_t blocker;  // another literal of the clause: if it's true, the clause doesn't need to be visited
+        };
+
+        /**
+        * @brief binary max-heap of variables by activity
+        */
+        class VariableHeap {
+            public:
+                explicit VariableHeap(const std::vector<double> & activity) : activity {activity}, heap {}, index {} { }
+
+                bool empty() const { return heap.empty(); }
+                bool contains(int v) const { return v < static_cast<int>(index.size()) && index[v] >= 0; }
+
+                void insert(int v);
+                int pop();
+
+                /**
+                * @brief restores the order after the activity of v increased
+                */
+                void increased(int v) { if (contains(v)) up(index[v]); }
+
+            private:
+                const std::vector<double> & activity;
+                std::vector<int> heap;
+                std::vector<int> index;  // position of every variable in the heap (-1 = not in it)
+
+                void up(std::size_t i);
+                void down(std::size_t i);
+        };
+
+        std::size_t n_vars;
+        bool unsatisfiable;  // found while adding the clauses
+
+        std::vector<lit_t> arena;  // all clauses
+        std::vector<std::vector<Watch>> watches;  // clauses watching every literal
+
+        std::vector<std::int8_t> values;  // value of every literal
+        std::vector<int> level;  // decision level of every assigned variable
+        std::vector<int> reason;  // clause that implied every assigned variable (no_reason for decisions)
+        std::vector<bool> polarity;  // last value of every variable (phase saving)
+        std::vector<lit_t> trail;  // assigned literals, in order
+        std::vector<std::size_t> trail_lim;  // start of every decision level in the trail
+        std::size_t qhead;  // next literal of the trail to propagate
+
+        std::vector<double> activity;
+        double var_inc;
+        VariableHeap order;
+        float cla_inc;
+        std::size_t max_learnts;
+        std::size_t n_learnts;
+
+        std::vector<bool> seen;  // scratch for analyze()
+        std::vector<lit_t> learnt_clause;
+        std::vector<bool> model;
+
+        Stats statistics;
+
+        static int var(lit_t p) { return p >> 1; }
+
+        std::int8_t value_of(lit_t p) const { return values[p]; }
+
+        int decision_level() const { return static_cast<int>(trail_lim.size()); }
+
+        std::uint32_t clause_size(int c) const { return static_cast<std::uint32_t>(arena[c]) >> 1; }
+        bool learnt(int c) const { return arena[c] & 1; }
+        float activity_of(int c) const { return std::bit_cast<float>(arena[c + 1]); }
+        void set_activity(int c, float a) { arena[c + 1] = std::bit_cast<lit_t>(a); }
+        lit_t * literals(int c) { return arena.data() + c + header_size; }
+
+        /**
+        * @brief adds a clause of at least 2 literals, watching the first two
+        * @return position of the clause in the arena
+        */
+        int add_clause(const std::vector<lit_t> & lits, bool learnt);
+
+        void assign(lit_t p, int from);
+
+        /**
+        * @brief propagates the pending literals of the trail
+        * @return conflicting clause, or no_reason
+        */
+        int propagate();
+
+        /**
+        * @brief builds the first-UIP learnt clause of a conflict (asserting literal first) into learnt_clause
+        * @return decision level to backjump to
+        */
+        int analyze(int conflict);
+
+        void backtrack(int target_level);
+
+        /**
+        * @brief searches until a solution, a conflict at level 0 or `budget` conflicts
+        * @return l_true (satisfiable), l_false (unsatisfiable) or l_undef (restart)
+        */
+        std::int8_t search(std::size_t budget);
+
+        /**
+        * @brief drops the least active half of the learnt clauses
+        */
+        void reduce_learnts();
+
+        void bump_variable(int v);
+        void bump_clause(int c);
+};
+
+
+
+#endif
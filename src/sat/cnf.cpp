@@ -0,0 +1,154 @@
+#include "cnf.hpp"
+
+#include <unordered_map>
+#include <stdexcept>
+#include <charconv>
+#include <limits>
+#include <algorithm>
+#include <cstdlib>
+
+#include "mappedfile.hpp"
+
+
+
+/* tokenizer helpers (not locale dependent) */
+
+static bool is_letter(char c) { return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z'); }
+
+static bool is_digit(char c) { return c >= '0' && c <= '9'; }
+
+static bool is_blank(char c) { return c == ' ' || c == '\t' || c == '\r' || c == '\n'; }
+
+
+static std::invalid_argument unexpected(std::string_view text, const char * at) {
+    if (at == text.data() + text.size()) return std::invalid_argument("unexpected end of input");
+    return std::invalid_argument("unexpected '" + std::string(1, *at) + "' at position " + std::to_string(at - text.data()));
+}
+
+
+
+CNF parse_problem(std::string_view problem) {
+    CNF cnf {};
+    std::unordered_map<std::string_view, int> variable {};  // views into the problem: every name is copied once, to cnf.names
+
+    const char * p = problem.data();
+    const char * end = p + problem.size();
+    bool negated = false;
+    const char * open = nullptr;  // last '(', while no variable follows it
+
+    while (p < end) {
+        const char c = *p;
+
+        if (is_letter(c)) {
+            open = nullptr;
+            const char * start = p;
+            while (p < end && (is_letter(*p) || is_digit(*p) || *p == '_')) ++p;
+
+            const std::string_view name {start, static_cast<std::size_t>(p - start)};
+            auto [it, added] = variable.try_emplace(name, cnf.names.size() + 1);
+            if (added) cnf.names.emplace_back(name);
+
+            cnf.literals.push_back(negated ? -it->second : it->second);
+            negated = false;
+            continue;
+        }
+
+        if (is_blank(c)) {
+            ++p;
+            continue;
+        }
+        if (negated) throw unexpected(problem, p);  // a '-' must be followed by a variable
+
+        if (c == '-') negated = true;
+        else if (c == '(') open = p;
+        else if (c == ')' && open) throw std::invalid_argument("empty clause at position " + std::to_string(open - problem.data()));
+        else if (c == '*') {
+            if (cnf.literals.size() > cnf.offsets.back()) cnf.end_clause();
+        }
+        else if (c != '+' && c != ')') throw unexpected(problem, p);
+
+        ++p;
+    }
+    if (negated) throw unexpected(problem, p);
+
+    if (cnf.literals.size() > cnf.offsets.back()) cnf.end_clause();
+    cnf.n_variables = cnf.names.size();
+
+    return cnf;
+}
+
+
+
+CNF parse_dimacs(std::string_view text) {
+    CNF cnf {};
+    cnf.literals.reserve(text.size() / 4);  // rough guess, a literal takes a few characters
+
+    const char * p = text.data();
+    const char * end = p + text.size();
+    std::size_t max_variable = 0;
+
+    auto skip_blanks = [&]() { while (p < end && is_blank(*p)) ++p; };
+    auto skip_line = [&]() { while (p < end && *p != '\n') ++p; };
+    auto read_number = [&]() {
+        long x = 0;
+        auto [next, error] = std::from_chars(p, end, x);
+        if (error != std::errc {} || x > std::numeric_limits<int>::max() || x < -std::numeric_limits<int>::max()) throw unexpected(text, p);
+        p = next;
+        return x;
+    };
+
+    while (true) {
+        skip_blanks();
+        if (p == end) break;
+
+        if (*p == 'c') skip_line();
+        else if (*p == '%') break;  // end marker of some benchmark sets
+        else if (*p == 'p') {
+            // p cnf <variables> <clauses>
+            ++p;
+            skip_blanks();
+            if (std::string_view(p, std::min<std::size_t>(3, end - p)) != "cnf") throw unexpected(text, p);
+            p += 3;
+
+            skip_blanks();
+            const long variables = read_number();
+            skip_blanks();
+            const long clauses = read_number();
+            if (variables < 0 || clauses < 0) throw std::invalid_argument("negative size in the DIMACS header");
+
+            cnf.n_variables = variables;
+            cnf.offsets.reserve(std::min<std::size_t>(clauses, text.size() / 2) + 1);  // a clause takes at least "0\n", whatever the header says
+        }
+        else {
+            const long x = read_number();
+            if (x == 0) cnf.end_clause();
+            else {
+                cnf.literals.push_back(x);
+                max_variable = std::max<std::size_t>(max_variable, std::labs(x));
+            }
+        }
+    }
+
+    if (cnf.literals.size() > cnf.offsets.back()) cnf.end_clause();  // last clause without a 0
+    cnf.n_variables = std::max(cnf.n_variables, max_variable);
+
+    return cnf;
+}
+
+
+
+CNF read_cnf(const std::string & path) {
+    const MappedFile file {path};
+    const std::string_view text = file.view();
+
+    std::size_t i = 0;
+    while (i < text.size() && is_blank(text[i])) ++i;
+
+    const bool dimacs = i < text.size() && (
+        is_digit(text[i]) ||
+        (text[i] == '-' && i + 1 < text.size() && is_digit(text[i + 1])) ||
+        ((text[i] == 'c' || text[i] == 'p') && (i + 1 == text.size() || is_blank(text[i + 1])))
+    );
+
+    return dimacs ? parse_dimacs(text) : parse_problem(text);
+}
@@ -0,0 +1,75 @@
+#ifndef CNF_HPP
+#define CNF_HPP
+
+
+#include <vector>
+#include <string>
+#include <string_view>
+#include <span>
+#include <cstddef>
+
+
+
+/**
+ * @brief formula in conjunctive normal form (AND of clauses, each an OR of literals)
+ *
+ * Variables are numbered from 1 and literals are +v / -v, as in DIMACS. Clauses are stored one after
+ * another in a single array.
+*/
+struct CNF {
+    std::vector<int> literals {};  // all clauses, concatenated
+    std::vector<std::size_t> offsets {0};  // clause i is literals[offsets[i] .. offsets[i + 1])
+    std::size_t n_variables = 0;
+    std::vector<std::string> names {};  // names[v - 1]: name of variable v in the problem (none in DIMACS, where they're numbers)
+
+    /**
+    * @brief number of clauses
+    */
+    std::size_t size() const { return offsets.size() - 1; }
+
+    /**
+    * @brief number of variables
+    */
+    std::size_t variables() const { return n_variables; }
+
+    std::span<const int> clause(std::size_t i) const {
+        return {literals.data() + offsets[i], literals.data() + offsets[i + 1]};
+    }
+
+    /**
+    * @brief name of variable v
+    */
+    std::string name(int v) const { return names.empty() ? std::to_string(v) : names[v - 1]; }
+
+    /**
+    * @brief closes the clause made of the literals added since the last one
+    */
+    void end_clause() { offsets.push_back(literals.size()); }
+};
+
+
+
+/**
+ * @brief parses a problem using parenthesis, * (AND), + (OR) & - (NOT). Variables are a letter followed by
+ * any letters, digits or _. E.g.: "((c+b+-c)*(a+b+c)*(-a+b+c))"
+ * @throws std::invalid_argument on unexpected characters, empty clauses "()" and a '-' not followed by a variable
+*/
+CNF parse_problem(std::string_view problem);
+
+/**
+ * @brief parses a formula in DIMACS CNF format: "c" comment lines, a "p cnf <variables> <clauses>" header and
+ * clauses as lists of non-zero integers, each ended by 0
+ * @throws std::invalid_argument on malformed input
+*/
+CNF parse_dimacs(std::string_view text);
+
+/**
+ * @brief reads a formula from a file, in DIMACS CNF format or the problem syntax of parse_problem.
+ * It's DIMACS if it starts (after blanks) with a number, or with a "c" or "p" line
+ * @throws std::runtime_error if the file can't be read, std::invalid_argument on malformed input
+*/
+CNF read_cnf(const std::string & path);
+
+
+
+#endif
@@ -27,6 +27,7 @@ logger.addHandler(handler)
 
 REPO_ROOT = Path(__file__).parent.parent
 SIMULATOR_EXEC: Path = REPO_ROOT/f"build/src/p2{'.exe' if platform.system() == 'Windows' else ''}"
+CHECK_EXEC: Path = REPO_ROOT/f"build/src/p2-check{'.exe' if platform.system() == 'Windows' else ''}"
 DATA_FOLDER = REPO_ROOT/"data/"
 
 if os.path.exists(REPO_ROOT/"report"):
@@ -77,74 +78,82 @@ def test(n: int, p: float, algorithm: str, iterations: int) -> pd.DataFrame:
     return results
 
 
-def test_n (n_min, n_max, probability, algorithm, n_tests):
+def sweep(n_range: str, p_range: str, algorithm: str, iterations: int, threads: int = 1) -> pd.DataFrame:
     """
-    Function to calculate the average duration depending on the n size (Number of vertices of the graph)
+    Runs `iterations` tests for every (n, p) of a grid in a single process (sweep mode of the simulator), reading
+    one JSON line per test as they finish.
+
+    :param n_range: Values of n, as "first:last[:step]".
+    :param p_range: Values of p, as "first:last:step".
+    :param algorithm: Algorithm to apply.
+    :param iterations: Number of tests of every point.
+    :param threads: Number of tests run at once (`0` = one per core). Tests running at once compete for the cores and
+        caches, so keep `1` when the durations matter.
+
+    :return: DataFrame with columns {n, p, result, duration}
     """
+    args = [
+        SIMULATOR_EXEC,
+        f"--n-range={n_range}",
+        f"--p-range={p_range}",
+        f"--algorithm={algorithm}",
+        f"--iterations={iterations}",
+        f"--threads={threads}",
+        "--nograph"
+    ]
 
-    results = pd.DataFrame(columns=['n', 'duration'])
-    
-    for n in range(n_min, n_max + 1):
-        print(f"n: {n}, p: {probability}, algorithm: {algorithm}", end='\r')
-        run = test(n, probability, algorithm, n_tests)
-        average_duration = run['duration'].mean()
-        results = results._append({'n': n, 'duration': average_duration}, ignore_index=True)
+    rows = []
+    with subprocess.Popen(args, stdout=subprocess.PIPE, text=True) as process:
+        for line in process.stdout:
+            t = json.loads(line)
+            rows.append({'n': t['n'], 'p': t['p'], 'result': t['result'], 'duration': t['duration']})
+            print(f"n: {t['n']}, p: {t['p']}, algorithm: {algorithm}", end='\r')
 
-    return results
+    if process.returncode != 0:
+        raise subprocess.CalledProcessError(process.returncode, args)
 
+    sys.stdout.write("\033[K")  # clear line
+    return pd.DataFrame(rows, columns=['n', 'p', 'result', 'duration'])
 
-def test_p (n, algorithm, n_tests):
+
+def self_check(instances: int = 200, seed: int = 1) -> bool:
     """
-    Function to calculate the average duration depending on the p (probability of edge between two nodes)
+    Runs every check of the checker executable, which compares the algorithms that answer the same question on
+    seeded random instances. The mismatches are described on stderr.
+
+    :param instances: Random instances per check.
+    :param seed: Seed of the instances.
+
+    :return: True if all the results agree
     """
+    args = [CHECK_EXEC, f"--instances={instances}", f"--seed={seed}"]
 
-    results = pd.DataFrame(
-        columns=[
-            'n',
-            'p',
-            'duration'
-        ]
-    )
+    with subprocess.Popen(args, stdout=subprocess.PIPE, text=True) as process:
+        for line in process.stdout:
+            c = json.loads(line)
+            logger.info(f"{c['check']}: {c['comparisons']} comparisons on {c['instances']} instances, {c['mismatches']} mismatches")
 
-    p = 0.1
-    while p <= 1:
-        print(f"n: {n}, p: {p}", end='\r')
-        durations = []
-
-        ''' 
-        # For each graph size, it is executed 10 times and then calculate the average execution time
-        for index in range(n_tests):
-            run = test(n, p, algorithm, 1)
-            durations.append(run['duration'][0])
-        
-        avg_duration = statistics.mean(durations)
-
-        #In the dataframe is saved the average time needed for each graph size
-        new_values = pd.DataFrame({'n': [n], 'p': [p], 'duration': [avg_duration]})
-        p+=0.1
-        results = pd.concat([results, new_values], ignore_index=True)
-        
-        '''
-        #Run a battery of tests with the n given and the n_tests number of times given
-        run = test(n, p, algorithm, n_tests)
-        
-        #Take the average duration for each n size
-        average_durations = run['duration'].mean()
-
-        #Save the results into a dataframe
-        new_row = pd.DataFrame({
-            'n': [n],
-            'p': [p],
-            'duration': [average_durations]
-        })
-        results = pd.concat([results, new_row], ignore_index=True)
-
-        p+=0.05
-
-        sys.stdout.write("\033[K")  # clear line
-
-    #print(results)
-    return results
+    return process.returncode == 0
+
+
+def test_n (n_min, n_max, probability, algorithm, n_tests, threads=1):
+    """
+    Function to calculate the average duration depending on the n size (Number of vertices of the graph).
+    The tests run one at a time unless `threads` says otherwise, so the durations don't include contention
+    """
+
+    run = sweep(f"{n_min}:{n_max}", f"{probability}", algorithm, n_tests, threads)
+    return run.groupby('n', as_index=False)['duration'].mean()
+
+
+def test_p (n, algorithm, n_tests, threads=1):
+    """
+    Function to calculate the average duration depending on the p (probability of edge between two nodes).
+    The tests run one at a time unless `threads` says otherwise, so the durations don't include contention
+    """
+
+    run = sweep(f"{n}", "0.1:1:0.05", algorithm, n_tests, threads)
+    return run.groupby(['n', 'p'], as_index=False)['duration'].mean()
 
 
 
@@ -301,6 +310,10 @@ if __name__ == "__main__":
     if not SIMULATOR_EXEC.exists():
         exit(f"TM simulator executable not found at {SIMULATOR_EXEC}. Have you run CMake?")
 
+    # the timings are only worth something if the algorithms agree
+    if CHECK_EXEC.exists() and not self_check():
+        exit("The algorithms don't agree, see the mismatches above")
+
     default_probability = 0.5
     DFS_worst_probability = 1
     default_n = 5